@@ -0,0 +1,1110 @@
+#if !defined(_WIN32)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#define CLAY_IMPLEMENTATION
+#include "../TestRaylib/3rdparty/clay.h"
+#include "../TestRaylib/renderer/raylib/clayray_batch.h"
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <threads.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+// ==========================================================
+// MARK: Config
+// ==========================================================
+
+#define BENCH_MAX_ELEMENT_COUNT (1 << 18)
+#define BENCH_DEFAULT_FRAMES 100
+#define BENCH_WARMUP_FRAMES 5
+// Frames laid out to size the context, long enough to see every text a scenario cycles through
+#define BENCH_PROBE_FRAMES 32
+#define BENCH_TEXT_BUFFER_SIZE (256 * 1024)
+#define BENCH_POINTER_QUERIES 1000
+#define BENCH_BATCH_BUILDS 100
+// Times every element of the last frame is looked up with Clay_GetElementData
+#define BENCH_ELEMENT_LOOKUP_ROUNDS 20
+#define BENCH_MAX_THREADS 64
+// Capacities a --grow context starts from, far below what any scenario needs
+#define BENCH_GROW_START_ELEMENT_COUNT 64
+#define BENCH_GROW_START_WORD_COUNT 128
+
+typedef struct BenchScenario {
+	const char* name;
+	void (*build)(int32_t count);
+	int32_t count;
+	// Optional, returns how many render commands are out of their expected order
+	int32_t (*verifyOrder)(Clay_RenderCommandArray renderCommands, int32_t count);
+} BenchScenario;
+
+typedef struct BenchResult {
+	int32_t elementCount;
+	int32_t renderCommandCount;
+	uint64_t totalNs;
+	int32_t frames;
+	uintptr_t arenaPersistentBytes;
+	uintptr_t arenaUsedBytes;
+	int32_t mismatchedCommands;
+	int32_t misorderedCommands;
+	uint64_t pointerLinearNs;
+	uint64_t pointerIndexedNs;
+	int32_t mismatchedPointerQueries;
+	double elementLookupNs;
+	int32_t missedElementLookups;
+	int32_t diffChanges;
+	float diffDamagedRatio;
+	uint64_t measureTextCalls;
+	ClayRayBatchStats batchStats;
+	uint64_t batchBuildNs;
+	bool failed;
+} BenchResult;
+
+// Minimal fork/join pool for Clay_SetParallelForFunction, the calling thread works on the tasks too
+typedef struct BenchThreadPool {
+	thrd_t workers[BENCH_MAX_THREADS];
+	int32_t workerCount;
+	mtx_t mutex;
+	cnd_t wake;
+	cnd_t done;
+	uint32_t generation;
+	int32_t busyWorkers;
+	bool quit;
+	void (*task)(int32_t taskIndex, void* taskData);
+	void* taskData;
+	int32_t taskCount;
+	atomic_int nextTask;
+} BenchThreadPool;
+
+static char gTextBuffer[BENCH_TEXT_BUFFER_SIZE];
+static int32_t gTextBufferLength = 0;
+static float gGlyphAdvance[256];
+static bool gClayErrorRaised = false;
+static bool gIncrementalLayout = false;
+static bool gLayoutDiff = false;
+static int32_t gThreadCount = 1;
+static bool gGrowContext = false;
+static bool gBatchStats = false;
+static Clay_MeasureTextCachePolicy gTextCachePolicy = {.maxUnusedFrames = 2};
+static BenchThreadPool gThreadPool;
+static int32_t gFrameIndex = 0;
+static char gDashboardValues[1024][16];
+
+static Clay_TextElementConfig gBodyTextConfig = {.fontSize = 16, .lineHeight = 20, .textColor = {20, 20, 20, 255}};
+static Clay_TextElementConfig gLabelTextConfig = {.fontSize = 24, .textColor = {255, 255, 255, 255}, .wrapMode = CLAY_TEXT_WRAP_NONE};
+
+// ==========================================================
+// MARK: Privates
+// ==========================================================
+
+static uint64_t PRIV_NowNs(void) {
+#if defined(_WIN32)
+	static LARGE_INTEGER frequency = {0};
+	if (frequency.QuadPart == 0) {
+		QueryPerformanceFrequency(&frequency);
+	}
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	return (uint64_t)((double)counter.QuadPart * 1e9 / (double)frequency.QuadPart);
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static void PRIV_HandleClayErrors(const Clay_ErrorData errorData) {
+	fprintf(stderr, "Clay error: %.*s\n", errorData.errorText.length, errorData.errorText.chars);
+	gClayErrorRaised = true;
+}
+
+// Deterministic stand-in for a real font: every byte has a fixed advance, scaled by font size
+static Clay_Dimensions PRIV_MeasureText(Clay_StringSlice text, Clay_TextElementConfig* config, void* userData) {
+	(void)userData;
+	float width = 0;
+	for (int32_t i = 0; i < text.length; i++) {
+		width += gGlyphAdvance[(uint8_t)text.chars[i]];
+	}
+	const float fontSize = (float)config->fontSize;
+	return (Clay_Dimensions){
+		.width = width * fontSize + (float)(config->letterSpacing * text.length),
+		.height = config->lineHeight > 0 ? (float)config->lineHeight : fontSize
+	};
+}
+
+static void PRIV_InitTestData(void) {
+	for (int i = 0; i < 256; i++) {
+		gGlyphAdvance[i] = 0.35f + (float)((i * 31) % 8) * 0.05f;
+	}
+
+	static const char* words[] = {
+		"lorem", "ipsum", "dolor", "sit", "amet", "consectetur", "adipiscing", "elit", "sed", "do",
+		"eiusmod", "tempor", "incididunt", "ut", "labore", "et", "dolore", "magna", "aliqua", "enim",
+		"ad", "minim", "veniam", "quis", "nostrud", "exercitation", "ullamco", "laboris", "nisi", "aliquip"
+	};
+	const int wordCount = (int)(sizeof(words) / sizeof(words[0]));
+	uint32_t seed = 0x12345678u;
+	while (gTextBufferLength < BENCH_TEXT_BUFFER_SIZE - 16) {
+		seed = seed * 1664525u + 1013904223u;
+		const char* word = words[(seed >> 16) % (uint32_t)wordCount];
+		const int32_t length = (int32_t)strlen(word);
+		memcpy(gTextBuffer + gTextBufferLength, word, (size_t)length);
+		gTextBufferLength += length;
+		gTextBuffer[gTextBufferLength++] = ' ';
+	}
+}
+
+// Returns a slice of the shared text buffer, the buffer outlives every frame so it is safe to mark it static
+static Clay_String PRIV_TextSlice(int32_t index, int32_t length) {
+	const int32_t offset = (int32_t)(((uint32_t)index * 7919u) % (uint32_t)(gTextBufferLength - length));
+	return (Clay_String){.isStaticallyAllocated = true, .length = length, .chars = gTextBuffer + offset};
+}
+
+// ==========================================================
+// MARK: Scenarios
+// ==========================================================
+
+// A single chain of nested containers, alternating direction so both axes propagate fit sizes the whole way up
+static void PRIV_BuildDeepNesting(int32_t count) {
+	CLAY(CLAY_ID("DeepNestingRoot"), {.layout = {.sizing = {CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0)}}}) {
+		for (int32_t i = 0; i < count; i++) {
+			Clay__OpenElement();
+			Clay__ConfigureOpenElement((Clay_ElementDeclaration){
+				.layout = {
+					.padding = CLAY_PADDING_ALL(1),
+					.childGap = 1,
+					.layoutDirection = (i & 1) ? CLAY_TOP_TO_BOTTOM : CLAY_LEFT_TO_RIGHT
+				},
+				.backgroundColor = {(float)(i % 255), 100, 100, 255}
+			});
+		}
+		CLAY_TEXT(CLAY_STRING("Leaf"), &gLabelTextConfig);
+		for (int32_t i = 0; i < count; i++) {
+			Clay__CloseElement();
+		}
+	}
+}
+
+// One parent with a flat list of children, mixing grow, fixed and fit sizing along the layout axis
+static void PRIV_BuildSiblings(int32_t count) {
+	CLAY(CLAY_ID("SiblingsRoot"), {
+		.layout = {.sizing = {CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0)}, .childGap = 1},
+		.backgroundColor = {200, 200, 200, 255}
+	}) {
+		for (int32_t i = 0; i < count; i++) {
+			Clay_SizingAxis width;
+			switch (i % 4) {
+			case 0: width = CLAY_SIZING_GROW(0); break;
+			case 1: width = CLAY_SIZING_FIXED((float)(2 + i % 5)); break;
+			case 2: width = CLAY_SIZING_GROW((float)(i % 3), 40); break;
+			default: width = CLAY_SIZING_FIT(1); break;
+			}
+			CLAY(CLAY_IDI("Sibling", i), {
+				.layout = {.sizing = {width, CLAY_SIZING_GROW(0)}},
+				.backgroundColor = {(float)(i % 255), 50, 150, 255}
+			}) {}
+		}
+	}
+}
+
+// Columns of paragraphs that wrap at word boundaries, exercising Clay__MeasureTextCached and line wrapping
+static void PRIV_BuildTextWrap(int32_t count) {
+	CLAY(CLAY_ID("TextWrapRoot"), {
+		.layout = {.sizing = {CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0)}, .padding = CLAY_PADDING_ALL(16), .childGap = 16},
+		.clip = {.vertical = true}
+	}) {
+		for (int32_t column = 0; column < 4; column++) {
+			CLAY(CLAY_IDI("TextColumn", column), {
+				.layout = {.sizing = {CLAY_SIZING_GROW(0), CLAY_SIZING_FIT(0)}, .childGap = 8, .layoutDirection = CLAY_TOP_TO_BOTTOM}
+			}) {
+				for (int32_t i = column; i < count; i += 4) {
+					CLAY_TEXT(PRIV_TextSlice(i, 200 + (i % 7) * 60), &gBodyTextConfig);
+				}
+			}
+		}
+	}
+}
+
+// Many floating panels attached to the root with scattered z indexes, each with a little content
+static void PRIV_BuildFloatingRoots(int32_t count) {
+	CLAY(CLAY_ID("FloatingRootsRoot"), {.layout = {.sizing = {CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0)}}}) {
+		for (int32_t i = 0; i < count; i++) {
+			CLAY(CLAY_IDI("FloatingPanel", i), {
+				.layout = {.padding = CLAY_PADDING_ALL(4), .childGap = 2, .layoutDirection = CLAY_TOP_TO_BOTTOM},
+				.backgroundColor = {40, 40, (float)(i % 255), 230},
+				.cornerRadius = CLAY_CORNER_RADIUS(4),
+				.floating = {
+					.attachTo = CLAY_ATTACH_TO_ROOT,
+					.offset = {(float)((i * 37) % 1800), (float)((i * 53) % 1000)},
+					.zIndex = (int16_t)((i * 7919) % 512)
+				}
+			}) {
+				CLAY_TEXT(CLAY_STRING("Tooltip"), &gLabelTextConfig);
+				CLAY_AUTO_ID({.layout = {.sizing = {CLAY_SIZING_FIXED(60), CLAY_SIZING_FIXED(4)}}, .backgroundColor = {255, 200, 0, 255}}) {}
+			}
+		}
+	}
+}
+
+// A few large floating windows over a large background grid, the independent trees a parallel layout can spread over threads
+static void PRIV_BuildFloatingWindows(int32_t count) {
+	const int32_t windowCount = 8;
+	const int32_t cellsPerTree = count / (windowCount + 1);
+	CLAY(CLAY_ID("FloatingWindowsRoot"), {.layout = {.sizing = {CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0)}, .layoutDirection = CLAY_TOP_TO_BOTTOM}}) {
+		for (int32_t window = 0; window <= windowCount; window++) {
+			// Window 0 is the background grid, the others float over it and hold the same kind of content
+			Clay_ElementDeclaration declaration = {
+				.layout = {.sizing = {CLAY_SIZING_GROW(0), CLAY_SIZING_FIT(0)}, .padding = CLAY_PADDING_ALL(4), .childGap = 2, .layoutDirection = CLAY_TOP_TO_BOTTOM},
+				.backgroundColor = {30, 30, (float)(window * 20), 255}
+			};
+			if (window > 0) {
+				declaration.layout.sizing = (Clay_Sizing){CLAY_SIZING_FIXED(320), CLAY_SIZING_FIT(0)};
+				declaration.floating = (Clay_FloatingElementConfig){
+					.attachTo = CLAY_ATTACH_TO_ROOT,
+					.offset = {(float)(window * 180), (float)(window * 90)},
+					.zIndex = (int16_t)window
+				};
+			}
+			CLAY(CLAY_IDI("FloatingWindow", window), declaration) {
+				for (int32_t row = 0; row * 16 < cellsPerTree; row++) {
+					CLAY_AUTO_ID({.layout = {.sizing = {CLAY_SIZING_GROW(0), CLAY_SIZING_FIT(0)}, .childGap = 2}}) {
+						for (int32_t i = row * 16; i < cellsPerTree && i < row * 16 + 16; i++) {
+							CLAY_AUTO_ID({
+								.layout = {.sizing = {CLAY_SIZING_GROW(0, 120), CLAY_SIZING_FIXED(12)}},
+								.backgroundColor = {(float)(i % 255), 80, 120, 255}
+							}) {}
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+// Tabs of wrapped paragraphs where the visible tab changes every few frames, so text leaves the screen and comes back
+static void PRIV_BuildTextTabs(int32_t count) {
+	const int32_t tabCount = 6;
+	const int32_t selectedTab = (gFrameIndex / 4) % tabCount;
+	CLAY(CLAY_ID("TextTabsRoot"), {.layout = {.sizing = {CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0)}, .padding = CLAY_PADDING_ALL(8), .childGap = 8, .layoutDirection = CLAY_TOP_TO_BOTTOM}}) {
+		CLAY(CLAY_ID("TextTabsHeader"), {.layout = {.childGap = 4}}) {
+			for (int32_t tab = 0; tab < tabCount; tab++) {
+				CLAY(CLAY_IDI("TextTab", tab), {.layout = {.padding = CLAY_PADDING_ALL(4)}, .backgroundColor = {60, 60, (float)(tab == selectedTab ? 200 : 60), 255}}) {
+					CLAY_TEXT(PRIV_TextSlice(tab, 10), &gLabelTextConfig);
+				}
+			}
+		}
+		CLAY(CLAY_ID("TextTabsPage"), {.layout = {.sizing = {CLAY_SIZING_FIXED(900), CLAY_SIZING_FIT(0)}, .childGap = 6, .layoutDirection = CLAY_TOP_TO_BOTTOM}}) {
+			for (int32_t i = 0; i < count; i++) {
+				CLAY_TEXT(PRIV_TextSlice(tabCount + selectedTab * count + i, 200), &gBodyTextConfig);
+			}
+		}
+	}
+}
+
+// A grid of mostly static panels where a single value label changes every frame, the common case for incremental layout
+static void PRIV_BuildDashboard(int32_t count) {
+	const int32_t changingPanel = gFrameIndex % count;
+	CLAY(CLAY_ID("DashboardRoot"), {
+		.layout = {.sizing = {CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0)}, .padding = CLAY_PADDING_ALL(8), .childGap = 8, .layoutDirection = CLAY_TOP_TO_BOTTOM}
+	}) {
+		for (int32_t row = 0; row * 8 < count; row++) {
+			CLAY(CLAY_IDI("DashboardRow", row), {.layout = {.sizing = {CLAY_SIZING_GROW(0), CLAY_SIZING_FIT(0)}, .childGap = 8}}) {
+				for (int32_t i = row * 8; i < count && i < row * 8 + 8; i++) {
+					const int32_t value = i * 37 + (i == changingPanel ? gFrameIndex : 0);
+					const int32_t length = snprintf(gDashboardValues[i % 1024], sizeof(gDashboardValues[0]), "%d.%02d", value / 100, value % 100);
+					CLAY(CLAY_IDI("DashboardPanel", i), {
+						.layout = {.sizing = {CLAY_SIZING_GROW(0), CLAY_SIZING_FIT(0)}, .padding = CLAY_PADDING_ALL(8), .childGap = 4, .layoutDirection = CLAY_TOP_TO_BOTTOM},
+						.backgroundColor = {30, 30, 40, 255},
+						.cornerRadius = CLAY_CORNER_RADIUS(6)
+					}) {
+						CLAY_TEXT(PRIV_TextSlice(i, 24), &gBodyTextConfig);
+						CLAY_TEXT(((Clay_String){.length = length, .chars = gDashboardValues[i % 1024]}), &gLabelTextConfig);
+						CLAY_AUTO_ID({.layout = {.sizing = {CLAY_SIZING_GROW(0), CLAY_SIZING_FIXED(6)}}, .backgroundColor = {60, 60, 70, 255}}) {
+							CLAY_AUTO_ID({.layout = {.sizing = {CLAY_SIZING_PERCENT((float)(i % 10) / 10.0f), CLAY_SIZING_GROW(0)}}, .backgroundColor = {80, 200, 120, 255}}) {}
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+// A long feed of cards in a scroll container that moves every frame, nothing else changes so incremental layout only positions again
+static void PRIV_BuildScrollFeed(int32_t count) {
+	CLAY(CLAY_ID("ScrollFeedRoot"), {
+		.layout = {.sizing = {CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0)}, .padding = CLAY_PADDING_ALL(16), .childGap = 12, .layoutDirection = CLAY_TOP_TO_BOTTOM},
+		.clip = {.vertical = true, .childOffset = {0, -(float)((gFrameIndex * 37) % (count * 40))}}
+	}) {
+		for (int32_t i = 0; i < count; i++) {
+			CLAY(CLAY_IDI("ScrollFeedCard", i), {
+				.layout = {.sizing = {CLAY_SIZING_GROW(0), CLAY_SIZING_FIT(0)}, .padding = CLAY_PADDING_ALL(12), .childGap = 6, .layoutDirection = CLAY_TOP_TO_BOTTOM},
+				.backgroundColor = {240, 240, 245, 255},
+				.cornerRadius = CLAY_CORNER_RADIUS(6),
+				.border = {.color = {200, 200, 210, 255}, .width = CLAY_BORDER_OUTSIDE(1)}
+			}) {
+				CLAY_TEXT(PRIV_TextSlice(i, 24), &gLabelTextConfig);
+				CLAY_TEXT(PRIV_TextSlice(count + i, 120 + (i % 5) * 40), &gBodyTextConfig);
+			}
+		}
+	}
+}
+
+// Nested rows and columns, each level mixing grow, fit, fixed and percent children, with some rows too narrow for their content so shrinking runs too
+static void PRIV_BuildNestedGrid(int32_t count) {
+	const int32_t panelCount = count / 40;
+	CLAY(CLAY_ID("NestedGridRoot"), {.layout = {.sizing = {CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0)}, .padding = CLAY_PADDING_ALL(4), .childGap = 4, .layoutDirection = CLAY_TOP_TO_BOTTOM}}) {
+		for (int32_t row = 0; row * 8 < panelCount; row++) {
+			CLAY(CLAY_IDI("NestedGridRow", row), {.layout = {.sizing = {CLAY_SIZING_GROW(0), CLAY_SIZING_FIT(0)}, .childGap = 4}}) {
+				for (int32_t panel = row * 8; panel < panelCount && panel < row * 8 + 8; panel++) {
+					CLAY_AUTO_ID({
+						.layout = {.sizing = {CLAY_SIZING_GROW(0), CLAY_SIZING_FIT(0)}, .padding = CLAY_PADDING_ALL(2), .childGap = 2, .layoutDirection = CLAY_TOP_TO_BOTTOM},
+						.backgroundColor = {30, 30, (float)(panel % 255), 255}
+					}) {
+						for (int32_t line = 0; line < 6; line++) {
+							// Every third line asks for more than the panel has, so its cells shrink
+							const float cellWidth = line % 3 == 0 ? 40.0f : 8.0f;
+							CLAY_AUTO_ID({.layout = {.sizing = {CLAY_SIZING_GROW(0), CLAY_SIZING_FIT(0)}, .childGap = 1}}) {
+								CLAY_AUTO_ID({.layout = {.sizing = {CLAY_SIZING_FIXED(cellWidth), CLAY_SIZING_FIXED(8)}}, .backgroundColor = {200, 80, 80, 255}}) {}
+								CLAY_AUTO_ID({.layout = {.sizing = {CLAY_SIZING_GROW(4, 60), CLAY_SIZING_GROW(0)}}, .backgroundColor = {80, 200, 80, 255}}) {}
+								CLAY_AUTO_ID({.layout = {.sizing = {CLAY_SIZING_PERCENT(0.2f), CLAY_SIZING_FIXED(6)}}, .backgroundColor = {80, 80, 200, 255}}) {}
+								CLAY_AUTO_ID({.layout = {.sizing = {CLAY_SIZING_FIT(cellWidth), CLAY_SIZING_FIT(4)}, .padding = CLAY_PADDING_ALL(1)}, .backgroundColor = {200, 200, 80, 255}}) {
+									CLAY_AUTO_ID({.layout = {.sizing = {CLAY_SIZING_GROW(0), CLAY_SIZING_FIXED(4)}}, .backgroundColor = {40, 40, 40, 255}}) {}
+								}
+								CLAY_AUTO_ID({.layout = {.sizing = {CLAY_SIZING_GROW(0), CLAY_SIZING_PERCENT(0.5f)}}, .backgroundColor = {80, 200, 200, 255}}) {}
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+// One wide row of grow cells with scattered min widths and some max widths, like a data grid row, so the grow pass has many distinct sizes to level
+static void PRIV_BuildGrowRow(int32_t count) {
+	CLAY(CLAY_ID("GrowRowRoot"), {.layout = {.sizing = {CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0)}}, .clip = {.horizontal = true}}) {
+		CLAY(CLAY_ID("GrowRow"), {.layout = {.sizing = {CLAY_SIZING_FIXED((float)count * 16), CLAY_SIZING_FIXED(24)}, .childGap = 1}}) {
+			for (int32_t i = 0; i < count; i++) {
+				const float minWidth = 2 + (float)((i * 7919) % 997) / 40.0f;
+				const float maxWidth = i % 5 == 0 ? minWidth + (float)(i % 7) : CLAY__MAXFLOAT;
+				CLAY(CLAY_IDI("GrowCell", i), {.layout = {.sizing = {CLAY_SIZING_GROW(minWidth, maxWidth), CLAY_SIZING_GROW(0)}}, .backgroundColor = {(float)(i % 255), 120, 60, 255}}) {}
+			}
+		}
+	}
+}
+
+// Floating panels must be drawn sorted by z-index, panels sharing a z-index in declaration order
+static int32_t PRIV_VerifyFloatingRootsOrder(Clay_RenderCommandArray renderCommands, int32_t count) {
+	uint32_t* expectedIds = malloc(sizeof(uint32_t) * (size_t)count);
+	int32_t expectedLength = 0;
+	for (int32_t zIndex = 0; zIndex < 512; zIndex++) {
+		for (int32_t i = 0; i < count; i++) {
+			if ((i * 7919) % 512 == zIndex) {
+				expectedIds[expectedLength++] = Clay_GetElementIdWithIndex(CLAY_STRING("FloatingPanel"), (uint32_t)i).id;
+			}
+		}
+	}
+	int32_t matched = 0;
+	for (int32_t i = 0; i < renderCommands.length && matched < expectedLength; i++) {
+		const Clay_RenderCommand* renderCommand = &renderCommands.internalArray[i];
+		if (renderCommand->commandType == CLAY_RENDER_COMMAND_TYPE_RECTANGLE && renderCommand->id == expectedIds[matched]) {
+			matched++;
+		}
+	}
+	free(expectedIds);
+	return expectedLength - matched;
+}
+
+static const BenchScenario gScenarios[] = {
+	{"deep-nesting", PRIV_BuildDeepNesting, 2000, NULL},
+	{"siblings-10k", PRIV_BuildSiblings, 10000, NULL},
+	{"siblings-50k", PRIV_BuildSiblings, 50000, NULL},
+	{"text-wrap", PRIV_BuildTextWrap, 400, NULL},
+	{"floating-roots-1k", PRIV_BuildFloatingRoots, 1000, PRIV_VerifyFloatingRootsOrder},
+	{"dashboard", PRIV_BuildDashboard, 512, NULL},
+	{"floating-windows", PRIV_BuildFloatingWindows, 36000, NULL},
+	{"text-tabs", PRIV_BuildTextTabs, 60, NULL},
+	{"scroll-feed", PRIV_BuildScrollFeed, 2000, NULL},
+	{"nested-grid-20k", PRIV_BuildNestedGrid, 20000, NULL},
+	{"grow-row-1k", PRIV_BuildGrowRow, 1000, NULL},
+	{"grow-row-10k", PRIV_BuildGrowRow, 10000, NULL},
+	{"grow-row-100k", PRIV_BuildGrowRow, 100000, NULL},
+};
+
+// ==========================================================
+// MARK: Thread Pool
+// ==========================================================
+
+static void PRIV_RunPoolTasks(BenchThreadPool* pool) {
+	for (int32_t taskIndex = atomic_fetch_add(&pool->nextTask, 1); taskIndex < pool->taskCount; taskIndex = atomic_fetch_add(&pool->nextTask, 1)) {
+		pool->task(taskIndex, pool->taskData);
+	}
+}
+
+static int PRIV_PoolWorker(void* userData) {
+	BenchThreadPool* pool = userData;
+	uint32_t seenGeneration = 0;
+	mtx_lock(&pool->mutex);
+	for (;;) {
+		while (!pool->quit && pool->generation == seenGeneration) {
+			cnd_wait(&pool->wake, &pool->mutex);
+		}
+		if (pool->quit) {
+			break;
+		}
+		seenGeneration = pool->generation;
+		mtx_unlock(&pool->mutex);
+		PRIV_RunPoolTasks(pool);
+		mtx_lock(&pool->mutex);
+		if (--pool->busyWorkers == 0) {
+			cnd_signal(&pool->done);
+		}
+	}
+	mtx_unlock(&pool->mutex);
+	return 0;
+}
+
+static void PRIV_ParallelFor(int32_t taskCount, void (*task)(int32_t taskIndex, void* taskData), void* taskData, void* userData) {
+	BenchThreadPool* pool = userData;
+	mtx_lock(&pool->mutex);
+	pool->task = task;
+	pool->taskData = taskData;
+	pool->taskCount = taskCount;
+	atomic_store(&pool->nextTask, 0);
+	pool->busyWorkers = pool->workerCount;
+	pool->generation++;
+	cnd_broadcast(&pool->wake);
+	mtx_unlock(&pool->mutex);
+
+	PRIV_RunPoolTasks(pool);
+
+	// Every worker has to check in, so none of them can still be reading this job when the next one starts
+	mtx_lock(&pool->mutex);
+	while (pool->busyWorkers > 0) {
+		cnd_wait(&pool->done, &pool->mutex);
+	}
+	mtx_unlock(&pool->mutex);
+}
+
+static void PRIV_StartThreadPool(BenchThreadPool* pool, int32_t threadCount) {
+	*pool = (BenchThreadPool){0};
+	mtx_init(&pool->mutex, mtx_plain);
+	cnd_init(&pool->wake);
+	cnd_init(&pool->done);
+	for (int32_t i = 0; i < threadCount - 1; i++) {
+		if (thrd_create(&pool->workers[pool->workerCount], PRIV_PoolWorker, pool) == thrd_success) {
+			pool->workerCount++;
+		}
+	}
+}
+
+static void PRIV_StopThreadPool(BenchThreadPool* pool) {
+	mtx_lock(&pool->mutex);
+	pool->quit = true;
+	cnd_broadcast(&pool->wake);
+	mtx_unlock(&pool->mutex);
+	for (int32_t i = 0; i < pool->workerCount; i++) {
+		thrd_join(pool->workers[i], NULL);
+	}
+	cnd_destroy(&pool->done);
+	cnd_destroy(&pool->wake);
+	mtx_destroy(&pool->mutex);
+}
+
+// ==========================================================
+// MARK: Runner
+// ==========================================================
+
+static int32_t PRIV_NextPowerOfTwo(int32_t value) {
+	int32_t result = 1;
+	while (result < value) {
+		result <<= 1;
+	}
+	return result;
+}
+
+static Clay_Context* PRIV_CreateContext(int32_t maxElementCount, int32_t maxMeasureTextCacheWordCount, void** outMemory) {
+	Clay_SetCurrentContext(NULL);
+	Clay_SetMaxElementCount(maxElementCount);
+	Clay_SetMaxMeasureTextCacheWordCount(maxMeasureTextCacheWordCount);
+	const uint32_t minMemorySize = Clay_MinMemorySize();
+	*outMemory = malloc(minMemorySize);
+	const Clay_Arena arena = Clay_CreateArenaWithCapacityAndMemory(minMemorySize, *outMemory);
+	Clay_Context* context = Clay_Initialize(arena, (Clay_Dimensions){1920, 1080}, (Clay_ErrorHandler){PRIV_HandleClayErrors, 0});
+	Clay_SetMeasureTextFunction(PRIV_MeasureText, NULL);
+	Clay_SetIncrementalLayoutEnabled(gIncrementalLayout);
+	Clay_SetParallelForFunction(gThreadCount > 1 ? PRIV_ParallelFor : NULL, &gThreadPool);
+	Clay_SetMeasureTextCachePolicy(gTextCachePolicy);
+	return context;
+}
+
+static void* PRIV_GrowAllocate(size_t size, void* userData) {
+	(void)userData;
+	return malloc(size);
+}
+
+static void PRIV_GrowFree(void* memory, void* userData) {
+	(void)userData;
+	free(memory);
+}
+
+static void PRIV_DestroyContext(void* memory) {
+	Clay_FreeGrownMemory();
+	Clay_SetCurrentContext(NULL);
+	free(memory);
+}
+
+// Lays the current frame out again from scratch on a single thread and counts render commands that differ from the measured result
+static int32_t PRIV_CompareWithReferenceLayout(const BenchScenario* scenario, Clay_RenderCommandArray measuredCommands) {
+	Clay_RenderCommand* expected = malloc(sizeof(Clay_RenderCommand) * (size_t)CLAY__MAX(measuredCommands.length, 1));
+	memcpy(expected, measuredCommands.internalArray, sizeof(Clay_RenderCommand) * (size_t)measuredCommands.length);
+	const int32_t expectedLength = measuredCommands.length;
+
+	Clay_SetIncrementalLayoutEnabled(false);
+	Clay_SetParallelForFunction(NULL, NULL);
+	Clay_BeginLayout();
+	scenario->build(scenario->count);
+	const Clay_RenderCommandArray fullCommands = Clay_EndLayout();
+	Clay_SetIncrementalLayoutEnabled(gIncrementalLayout);
+	Clay_SetParallelForFunction(gThreadCount > 1 ? PRIV_ParallelFor : NULL, &gThreadPool);
+
+	int32_t mismatches = abs(fullCommands.length - expectedLength);
+	for (int32_t i = 0; i < CLAY__MIN(fullCommands.length, expectedLength); i++) {
+		const Clay_RenderCommand* a = &expected[i];
+		const Clay_RenderCommand* b = &fullCommands.internalArray[i];
+		if (a->id != b->id || a->commandType != b->commandType || memcmp(&a->boundingBox, &b->boundingBox, sizeof(Clay_BoundingBox)) != 0) {
+			mismatches++;
+		}
+	}
+	free(expected);
+	return mismatches;
+}
+
+// Times pointer hit testing against the last layout, and checks that the spatial index reports exactly what a full walk does
+static void PRIV_RunPointerQueries(BenchResult* result) {
+	Clay_Context* context = Clay_GetCurrentContext();
+	static Clay_Vector2 positions[BENCH_POINTER_QUERIES];
+	uint32_t seed = 0x9e3779b9u;
+	for (int32_t i = 0; i < BENCH_POINTER_QUERIES; i++) {
+		seed = seed * 1664525u + 1013904223u;
+		positions[i].x = (float)(seed >> 8) / (float)(1 << 24) * context->layoutDimensions.width;
+		seed = seed * 1664525u + 1013904223u;
+		positions[i].y = (float)(seed >> 8) / (float)(1 << 24) * context->layoutDimensions.height;
+	}
+
+	uint64_t start = PRIV_NowNs();
+	for (int32_t i = 0; i < BENCH_POINTER_QUERIES; i++) {
+		Clay__UpdatePointerOverIdsLinear(positions[i]);
+	}
+	result->pointerLinearNs = (PRIV_NowNs() - start) / BENCH_POINTER_QUERIES;
+
+	// Includes building the index on the first query
+	start = PRIV_NowNs();
+	for (int32_t i = 0; i < BENCH_POINTER_QUERIES; i++) {
+		Clay_SetPointerState(positions[i], false);
+	}
+	result->pointerIndexedNs = (PRIV_NowNs() - start) / BENCH_POINTER_QUERIES;
+
+	Clay_ElementId* expected = malloc(sizeof(Clay_ElementId) * (size_t)context->pointerOverIds.capacity);
+	for (int32_t i = 0; i < BENCH_POINTER_QUERIES; i++) {
+		Clay__UpdatePointerOverIdsLinear(positions[i]);
+		const int32_t expectedLength = context->pointerOverIds.length;
+		memcpy(expected, context->pointerOverIds.internalArray, sizeof(Clay_ElementId) * (size_t)expectedLength);
+		Clay_SetPointerState(positions[i], false);
+		bool matches = context->pointerOverIds.length == expectedLength;
+		for (int32_t j = 0; matches && j < expectedLength; j++) {
+			matches = context->pointerOverIds.internalArray[j].id == expected[j].id;
+		}
+		result->mismatchedPointerQueries += matches ? 0 : 1;
+	}
+	free(expected);
+}
+
+// Times Clay_GetElementData for every element of the last layout, each of them has to be found
+static void PRIV_RunElementLookups(BenchResult* result) {
+	Clay_Context* context = Clay_GetCurrentContext();
+	const int32_t elementCount = context->layoutElements.length;
+	int32_t found = 0;
+	const uint64_t start = PRIV_NowNs();
+	for (int32_t round = 0; round < BENCH_ELEMENT_LOOKUP_ROUNDS; round++) {
+		for (int32_t i = 0; i < elementCount; i++) {
+			found += Clay_GetElementData((Clay_ElementId){.id = context->layoutElements.internalArray[i].id}).found ? 1 : 0;
+		}
+	}
+	result->elementLookupNs = (double)(PRIV_NowNs() - start) / (double)CLAY__MAX(elementCount * BENCH_ELEMENT_LOOKUP_ROUNDS, 1);
+	result->missedElementLookups = elementCount * BENCH_ELEMENT_LOOKUP_ROUNDS - found;
+}
+
+static BenchResult PRIV_RunScenario(const BenchScenario* scenario, int32_t frames) {
+	BenchResult result = {.frames = frames};
+	gClayErrorRaised = false;
+	void* memory = NULL;
+
+	// Probe frames on an oversized context, so the measured context can be sized to what the scenario really needs.
+	// Measurements are never dropped while probing, so the word cache fits every text the scenario shows.
+	// With --grow the context starts tiny instead, and grows during the warmup until the scenario fits.
+	Clay_Context* context = NULL;
+	int32_t warmupFrames = BENCH_WARMUP_FRAMES;
+	if (gGrowContext) {
+		context = PRIV_CreateContext(BENCH_GROW_START_ELEMENT_COUNT, BENCH_GROW_START_WORD_COUNT, &memory);
+		Clay_SetGrowFunctions(PRIV_GrowAllocate, PRIV_GrowFree, NULL);
+		warmupFrames = BENCH_PROBE_FRAMES;
+	}
+	else {
+		context = PRIV_CreateContext(BENCH_MAX_ELEMENT_COUNT, BENCH_MAX_ELEMENT_COUNT * 2, &memory);
+		Clay_SetMeasureTextCachePolicy((Clay_MeasureTextCachePolicy){0});
+		int32_t probeElementCount = 0;
+		for (gFrameIndex = 0; gFrameIndex < BENCH_PROBE_FRAMES; gFrameIndex++) {
+			Clay_BeginLayout();
+			scenario->build(scenario->count);
+			Clay_EndLayout();
+			// Wrapped text lines, render commands and text measurements share the element capacity, so the largest of them decides it
+			probeElementCount = CLAY__MAX(probeElementCount, CLAY__MAX(context->layoutElements.length, CLAY__MAX(context->wrappedTextLines.length, context->renderCommands.length)));
+			probeElementCount = CLAY__MAX(probeElementCount, context->measureTextHashMapInternal.length);
+		}
+		const int32_t probeWordCount = context->measuredWords.length;
+		PRIV_DestroyContext(memory);
+
+		// Every scenario gets a fresh context so arena usage and caches don't leak between them
+		context = PRIV_CreateContext(
+			PRIV_NextPowerOfTwo(probeElementCount + 64),
+			PRIV_NextPowerOfTwo(CLAY__MAX(probeWordCount + 64, 1024)),
+			&memory
+		);
+	}
+
+	gFrameIndex = 0;
+	for (int32_t i = 0; i < warmupFrames; i++) {
+		gFrameIndex++;
+		Clay_BeginLayout();
+		scenario->build(scenario->count);
+		if (gLayoutDiff) {
+			Clay_EndLayoutDiff();
+		}
+		else {
+			Clay_EndLayout();
+		}
+	}
+
+	// Frames that overflowed before the context grew report capacity errors, only the measured frames count
+	gClayErrorRaised = false;
+	Clay_RenderCommandArray renderCommands = {0};
+	Clay_LayoutDiff diff = {0};
+	Clay_ResetMeasureTextCacheStats();
+	const uint64_t start = PRIV_NowNs();
+	for (int32_t i = 0; i < frames; i++) {
+		gFrameIndex++;
+		Clay_BeginLayout();
+		scenario->build(scenario->count);
+		if (gLayoutDiff) {
+			diff = Clay_EndLayoutDiff();
+			renderCommands = diff.renderCommands;
+		}
+		else {
+			renderCommands = Clay_EndLayout();
+		}
+	}
+	result.totalNs = PRIV_NowNs() - start;
+	result.measureTextCalls = Clay_GetMeasureTextCacheStats().measureTextCalls;
+
+	if (gLayoutDiff) {
+		float damagedArea = 0;
+		for (int32_t i = 0; i < diff.damageRects.length; i++) {
+			damagedArea += diff.damageRects.internalArray[i].width * diff.damageRects.internalArray[i].height;
+		}
+		result.diffChanges = diff.changes.length;
+		result.diffDamagedRatio = damagedArea / (context->layoutDimensions.width * context->layoutDimensions.height);
+	}
+
+	result.elementCount = context->layoutElements.length;
+	result.renderCommandCount = renderCommands.length;
+	result.arenaPersistentBytes = context->arenaResetOffset;
+	result.arenaUsedBytes = context->internalArena.nextAllocation;
+	PRIV_RunPointerQueries(&result);
+	PRIV_RunElementLookups(&result);
+	if (gBatchStats) {
+		// Batches the last frame the way the raylib renderer would, without a GPU
+		ClayRayBatch batch = {0};
+		const uint64_t batchStart = PRIV_NowNs();
+		for (int32_t i = 0; i < BENCH_BATCH_BUILDS; i++) {
+			ClayRayBatch_Build(&batch, renderCommands, NULL);
+		}
+		result.batchBuildNs = (PRIV_NowNs() - batchStart) / BENCH_BATCH_BUILDS;
+		result.batchStats = batch.stats;
+		ClayRayBatch_Free(&batch);
+	}
+	if (scenario->verifyOrder) {
+		result.misorderedCommands = scenario->verifyOrder(renderCommands, scenario->count);
+	}
+	if (gIncrementalLayout || gThreadCount > 1 || gGrowContext) {
+		result.mismatchedCommands = PRIV_CompareWithReferenceLayout(scenario, renderCommands);
+	}
+	result.failed = gClayErrorRaised || result.mismatchedCommands > 0 || result.misorderedCommands > 0 || result.mismatchedPointerQueries > 0 || result.missedElementLookups > 0;
+
+	PRIV_DestroyContext(memory);
+	return result;
+}
+
+static void PRIV_PrintResult(const BenchScenario* scenario, const BenchResult* result) {
+	const double nsPerFrame = (double)result->totalNs / (double)result->frames;
+	const double nsPerElement = result->elementCount > 0 ? nsPerFrame / (double)result->elementCount : 0;
+	const double commandsPerSecond = result->totalNs > 0 ? (double)result->renderCommandCount * (double)result->frames * 1e9 / (double)result->totalNs : 0;
+	printf("%-18s %9d %9d %12.1f %10.2f %14.0f %12zu %12zu %11llu %11llu %11.1f %10.1f",
+	       scenario->name,
+	       result->elementCount,
+	       result->renderCommandCount,
+	       nsPerFrame / 1000.0,
+	       nsPerElement,
+	       commandsPerSecond,
+	       (size_t)result->arenaPersistentBytes,
+	       (size_t)result->arenaUsedBytes,
+	       (unsigned long long)result->pointerLinearNs,
+	       (unsigned long long)result->pointerIndexedNs,
+	       result->elementLookupNs,
+	       (double)result->measureTextCalls / (double)result->frames);
+	if (gLayoutDiff) {
+		printf("  (last frame: %d changes, %.1f%% damaged)", result->diffChanges, result->diffDamagedRatio * 100.0f);
+	}
+	if (result->missedElementLookups > 0) {
+		printf("  (%d element lookups failed)", result->missedElementLookups);
+	}
+	else if (result->mismatchedPointerQueries > 0) {
+		printf("  (%d pointer queries differ from a full walk)", result->mismatchedPointerQueries);
+	}
+	else if (result->misorderedCommands > 0) {
+		printf("  (%d commands drawn out of z-index order)", result->misorderedCommands);
+	}
+	else if (result->mismatchedCommands > 0) {
+		printf("  (%d commands differ from a single threaded full layout)", result->mismatchedCommands);
+	}
+	else if (result->failed) {
+		printf("  (clay reported errors)");
+	}
+	printf("\n");
+	if (gBatchStats) {
+		const ClayRayBatchStats* stats = &result->batchStats;
+		printf("%-18s batch: %d vertices, %d draws (%d geometry, %d text, %d image, %d custom), %d scissor changes, %d shape draws unbatched, built in %.1f us\n",
+		       "",
+		       stats->vertices,
+		       stats->geometryDraws + stats->textDraws + stats->imageDraws + stats->customDraws,
+		       stats->geometryDraws,
+		       stats->textDraws,
+		       stats->imageDraws,
+		       stats->customDraws,
+		       stats->scissorChanges,
+		       stats->unbatchedShapeDraws,
+		       (double)result->batchBuildNs / 1000.0);
+	}
+}
+
+// ==========================================================
+// MARK: Size Distribution
+// ==========================================================
+
+// Rounds of random inputs --distribution compares against the reference
+#define BENCH_DISTRIBUTION_CASES 20000
+// The reference stops with up to CLAY__EPSILON undistributed and merges sizes closer than that, so results only agree that closely
+#define BENCH_DISTRIBUTION_TOLERANCE (CLAY__EPSILON * 2)
+
+// The grow and shrink loops Clay__DistributeSizeToChildren replaced, kept to check it against. Each round levels the largest (shrink)
+// or smallest (grow) children to the next size, so it takes a pass over every child per distinct size: O(n^2) on rows of unequal children.
+// The original never finished once a child's share of what was left fell below float precision, with ~100k children, so this stops when a round changes nothing.
+static void PRIV_ReferenceDistribute(float* sizes, const float* limits, Clay__int32_tArray resizableContainerBuffer, float sizeToDistribute, float direction) {
+	if (direction < 0) {
+		while (sizeToDistribute < -CLAY__EPSILON && resizableContainerBuffer.length > 0) {
+			const float previousSizeToDistribute = sizeToDistribute;
+			const int32_t previousLength = resizableContainerBuffer.length;
+			float largest = 0;
+			float secondLargest = 0;
+			float widthToAdd = sizeToDistribute;
+			for (int childIndex = 0; childIndex < resizableContainerBuffer.length; childIndex++) {
+				float childSize = sizes[resizableContainerBuffer.internalArray[childIndex]];
+				if (Clay__FloatEqual(childSize, largest)) { continue; }
+				if (childSize > largest) {
+					secondLargest = largest;
+					largest = childSize;
+				}
+				if (childSize < largest) {
+					secondLargest = CLAY__MAX(secondLargest, childSize);
+					widthToAdd = secondLargest - largest;
+				}
+			}
+			widthToAdd = CLAY__MAX(widthToAdd, sizeToDistribute / resizableContainerBuffer.length);
+			for (int childIndex = 0; childIndex < resizableContainerBuffer.length; childIndex++) {
+				int32_t childElementIndex = resizableContainerBuffer.internalArray[childIndex];
+				float* childSize = &sizes[childElementIndex];
+				float previousWidth = *childSize;
+				if (Clay__FloatEqual(*childSize, largest)) {
+					*childSize += widthToAdd;
+					if (*childSize <= limits[childElementIndex]) {
+						*childSize = limits[childElementIndex];
+						Clay__int32_tArray_RemoveSwapback(&resizableContainerBuffer, childIndex--);
+					}
+					sizeToDistribute -= (*childSize - previousWidth);
+				}
+			}
+			if (sizeToDistribute == previousSizeToDistribute && resizableContainerBuffer.length == previousLength) {
+				break;
+			}
+		}
+		return;
+	}
+	while (sizeToDistribute > CLAY__EPSILON && resizableContainerBuffer.length > 0) {
+		const float previousSizeToDistribute = sizeToDistribute;
+		const int32_t previousLength = resizableContainerBuffer.length;
+		float smallest = CLAY__MAXFLOAT;
+		float secondSmallest = CLAY__MAXFLOAT;
+		float widthToAdd = sizeToDistribute;
+		for (int childIndex = 0; childIndex < resizableContainerBuffer.length; childIndex++) {
+			float childSize = sizes[resizableContainerBuffer.internalArray[childIndex]];
+			if (Clay__FloatEqual(childSize, smallest)) { continue; }
+			if (childSize < smallest) {
+				secondSmallest = smallest;
+				smallest = childSize;
+			}
+			if (childSize > smallest) {
+				secondSmallest = CLAY__MIN(secondSmallest, childSize);
+				widthToAdd = secondSmallest - smallest;
+			}
+		}
+		widthToAdd = CLAY__MIN(widthToAdd, sizeToDistribute / resizableContainerBuffer.length);
+		for (int childIndex = 0; childIndex < resizableContainerBuffer.length; childIndex++) {
+			int32_t childElementIndex = resizableContainerBuffer.internalArray[childIndex];
+			float* childSize = &sizes[childElementIndex];
+			float previousWidth = *childSize;
+			if (Clay__FloatEqual(*childSize, smallest)) {
+				*childSize += widthToAdd;
+				if (*childSize >= limits[childElementIndex]) {
+					*childSize = limits[childElementIndex];
+					Clay__int32_tArray_RemoveSwapback(&resizableContainerBuffer, childIndex--);
+				}
+				sizeToDistribute -= (*childSize - previousWidth);
+			}
+		}
+		if (sizeToDistribute == previousSizeToDistribute && resizableContainerBuffer.length == previousLength) {
+			break;
+		}
+	}
+}
+
+typedef struct BenchDistributionCase {
+	int32_t count;
+	float* sizes;
+	float* limits;
+	float* results;
+	Clay__int32_tArray children;
+	Clay__int32_tArray limitBuffer;
+} BenchDistributionCase;
+
+static BenchDistributionCase PRIV_AllocateDistributionCase(int32_t capacity) {
+	return (BenchDistributionCase){
+		.sizes = malloc(sizeof(float) * (size_t)capacity),
+		.limits = malloc(sizeof(float) * (size_t)capacity),
+		.results = malloc(sizeof(float) * (size_t)capacity),
+		.children = {.capacity = capacity, .internalArray = malloc(sizeof(int32_t) * (size_t)capacity)},
+		.limitBuffer = {.capacity = capacity, .internalArray = malloc(sizeof(int32_t) * (size_t)capacity)},
+	};
+}
+
+static void PRIV_FreeDistributionCase(BenchDistributionCase* distributionCase) {
+	free(distributionCase->sizes);
+	free(distributionCase->limits);
+	free(distributionCase->results);
+	free(distributionCase->children.internalArray);
+	free(distributionCase->limitBuffer.internalArray);
+}
+
+static uint32_t PRIV_NextRandom(uint32_t* seed) {
+	*seed = *seed * 1664525u + 1013904223u;
+	return *seed >> 8;
+}
+
+// Children with sizes from a handful of values, so ties and near ties are common, and limits ahead of their size in the direction of the
+// distribution. Some children start at their limit, some have none. Returns the size to distribute, sometimes more than the children can take.
+static float PRIV_FillRandomDistributionCase(BenchDistributionCase* distributionCase, int32_t count, float direction, uint32_t* seed) {
+	distributionCase->count = count;
+	distributionCase->children.length = count;
+	const uint32_t distinctSizes = 1 + PRIV_NextRandom(seed) % 8;
+	float room = 0;
+	for (int32_t i = 0; i < count; i++) {
+		float size = 10 + (float)(PRIV_NextRandom(seed) % distinctSizes) * 7.5f;
+		if (PRIV_NextRandom(seed) % 4 == 0) {
+			size += (float)(PRIV_NextRandom(seed) % 100) / 1000.0f;
+		}
+		const uint32_t limitKind = PRIV_NextRandom(seed) % 8;
+		float limit = limitKind == 0 ? size : size + direction * (float)(PRIV_NextRandom(seed) % 400) / 16.0f;
+		if (limitKind == 1) {
+			limit = direction > 0 ? CLAY__MAXFLOAT : 0;
+		}
+		// Min sizes are never negative, and the reference shrink loop relies on it
+		limit = direction < 0 ? CLAY__MAX(limit, 0) : limit;
+		distributionCase->sizes[i] = size;
+		distributionCase->limits[i] = limit;
+		distributionCase->children.internalArray[i] = i;
+		room += limitKind == 1 && direction > 0 ? 100 : (limit - size) * direction;
+	}
+	return direction * room * (float)(PRIV_NextRandom(seed) % 1200) / 1000.0f;
+}
+
+static void PRIV_RunDistribution(BenchDistributionCase* distributionCase, float sizeToDistribute, float direction, bool reference) {
+	memcpy(distributionCase->results, distributionCase->sizes, sizeof(float) * (size_t)distributionCase->count);
+	for (int32_t i = 0; i < distributionCase->count; i++) {
+		distributionCase->children.internalArray[i] = i;
+	}
+	distributionCase->children.length = distributionCase->count;
+	if (reference) {
+		PRIV_ReferenceDistribute(distributionCase->results, distributionCase->limits, distributionCase->children, sizeToDistribute, direction);
+	}
+	else {
+		Clay__DistributeSizeToChildren(distributionCase->results, distributionCase->limits, distributionCase->children, distributionCase->limitBuffer, sizeToDistribute, direction);
+	}
+}
+
+// Compares Clay__DistributeSizeToChildren with the reference on random rows, returns how many children ended up at a different size
+static int32_t PRIV_CheckDistribution(void) {
+	BenchDistributionCase expected = PRIV_AllocateDistributionCase(64);
+	BenchDistributionCase actual = PRIV_AllocateDistributionCase(64);
+	uint32_t seed = 0x2545f491u;
+	int32_t mismatches = 0;
+	float largestDifference = 0;
+	for (int32_t round = 0; round < BENCH_DISTRIBUTION_CASES; round++) {
+		const float direction = round % 2 == 0 ? 1.0f : -1.0f;
+		const int32_t count = 1 + (int32_t)(PRIV_NextRandom(&seed) % 64);
+		const float sizeToDistribute = PRIV_FillRandomDistributionCase(&expected, count, direction, &seed);
+		memcpy(actual.sizes, expected.sizes, sizeof(float) * (size_t)count);
+		memcpy(actual.limits, expected.limits, sizeof(float) * (size_t)count);
+		actual.count = count;
+		PRIV_RunDistribution(&expected, sizeToDistribute, direction, true);
+		PRIV_RunDistribution(&actual, sizeToDistribute, direction, false);
+		for (int32_t i = 0; i < count; i++) {
+			const float difference = actual.results[i] > expected.results[i] ? actual.results[i] - expected.results[i] : expected.results[i] - actual.results[i];
+			largestDifference = CLAY__MAX(largestDifference, difference);
+			mismatches += difference > BENCH_DISTRIBUTION_TOLERANCE ? 1 : 0;
+		}
+	}
+	printf("%d random rows, largest difference from the reference %.5f, %d children beyond %.2f\n", BENCH_DISTRIBUTION_CASES, (double)largestDifference, mismatches, (double)BENCH_DISTRIBUTION_TOLERANCE);
+	PRIV_FreeDistributionCase(&expected);
+	PRIV_FreeDistributionCase(&actual);
+	return mismatches;
+}
+
+// Times both implementations on rows shaped like PRIV_BuildGrowRow, growing into 10% more space and shrinking by 10%
+static void PRIV_BenchDistribution(int32_t count, float direction) {
+	BenchDistributionCase distributionCase = PRIV_AllocateDistributionCase(count);
+	distributionCase.count = count;
+	float room = 0;
+	for (int32_t i = 0; i < count; i++) {
+		const float minWidth = 2 + (float)((i * 7919) % 997) / 40.0f;
+		distributionCase.sizes[i] = direction > 0 ? minWidth : minWidth * 2;
+		distributionCase.limits[i] = direction > 0 ? (i % 5 == 0 ? minWidth + (float)(i % 7) : CLAY__MAXFLOAT) : minWidth;
+		room += minWidth;
+	}
+	const float sizeToDistribute = direction * room * 0.1f;
+	const int32_t rounds = CLAY__MAX(1, 100000 / count);
+	uint64_t elapsedNs[2];
+	for (int32_t reference = 0; reference < 2; reference++) {
+		const uint64_t start = PRIV_NowNs();
+		for (int32_t round = 0; round < rounds; round++) {
+			PRIV_RunDistribution(&distributionCase, sizeToDistribute, direction, reference == 1);
+		}
+		elapsedNs[reference] = (PRIV_NowNs() - start) / (uint64_t)rounds;
+	}
+	printf("%-8s %9d %14.1f %14.1f\n", direction > 0 ? "grow" : "shrink", count, (double)elapsedNs[1] / 1000.0, (double)elapsedNs[0] / 1000.0);
+	PRIV_FreeDistributionCase(&distributionCase);
+}
+
+// ==========================================================
+// MARK: Main
+// ==========================================================
+
+// Usage: ClayBench [--incremental] [--diff] [--threads N] [--text-cache-lru] [--pin-static-text] [--grow] [--batch-stats] [--distribution] [frames] [scenario-name]
+int main(int argc, char** argv) {
+	int32_t frames = BENCH_DEFAULT_FRAMES;
+	const char* filter = NULL;
+	bool distribution = false;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--incremental") == 0) {
+			gIncrementalLayout = true;
+		}
+		else if (strcmp(argv[i], "--diff") == 0) {
+			gLayoutDiff = true;
+		}
+		else if (strcmp(argv[i], "--text-cache-lru") == 0) {
+			gTextCachePolicy.maxUnusedFrames = 0;
+		}
+		else if (strcmp(argv[i], "--pin-static-text") == 0) {
+			gTextCachePolicy.pinStaticStrings = true;
+		}
+		else if (strcmp(argv[i], "--batch-stats") == 0) {
+			gBatchStats = true;
+		}
+		else if (strcmp(argv[i], "--grow") == 0) {
+			gGrowContext = true;
+		}
+		else if (strcmp(argv[i], "--distribution") == 0) {
+			distribution = true;
+		}
+		else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+			gThreadCount = (int32_t)strtol(argv[++i], NULL, 10);
+		}
+		else if (argv[i][0] >= '0' && argv[i][0] <= '9') {
+			frames = (int32_t)strtol(argv[i], NULL, 10);
+		}
+		else {
+			filter = argv[i];
+		}
+	}
+	if (frames <= 0 || gThreadCount < 1 || gThreadCount > BENCH_MAX_THREADS) {
+		fprintf(stderr, "Usage: %s [--incremental] [--diff] [--threads N] [--text-cache-lru] [--pin-static-text] [--grow] [--batch-stats] [--distribution] [frames] [scenario-name]\n", argv[0]);
+		return 1;
+	}
+
+	// Checks and times the grow and shrink distribution alone, instead of running the scenarios
+	if (distribution) {
+		const int32_t mismatches = PRIV_CheckDistribution();
+		printf("%-8s %9s %14s %14s\n", "pass", "children", "us-reference", "us-waterfill");
+		for (int32_t count = 1000; count <= 100000; count *= 10) {
+			PRIV_BenchDistribution(count, 1);
+			PRIV_BenchDistribution(count, -1);
+		}
+		return mismatches == 0 ? 0 : 1;
+	}
+
+	PRIV_InitTestData();
+	if (gThreadCount > 1) {
+		PRIV_StartThreadPool(&gThreadPool, gThreadCount);
+	}
+
+	printf("incremental layout: %s\n", gIncrementalLayout ? "on (verified against a full layout)" : "off");
+	printf("render command diff: %s\n", gLayoutDiff ? "on" : "off");
+	printf("layout threads: %d%s\n", gThreadCount, gThreadCount > 1 ? " (verified against a single thread)" : "");
+	printf("context: %s\n", gGrowContext ? "grown from a tiny capacity (verified against a full layout)" : "sized from probe frames");
+	printf("text cache: %s%s\n", gTextCachePolicy.maxUnusedFrames > 0 ? "drop after 2 unused frames" : "least recently used", gTextCachePolicy.pinStaticStrings ? ", static strings pinned" : "");
+	printf("%-18s %9s %9s %12s %10s %14s %12s %12s %11s %11s %11s %10s\n",
+	       "scenario", "elements", "commands", "us/frame", "ns/elem", "commands/s", "arena-fixed", "arena-used", "ns/ptr-walk", "ns/ptr-bvh", "ns/get-data", "measures/f");
+
+	int failures = 0;
+	for (size_t i = 0; i < sizeof(gScenarios) / sizeof(gScenarios[0]); i++) {
+		const BenchScenario* scenario = &gScenarios[i];
+		if (filter && strcmp(filter, scenario->name) != 0) {
+			continue;
+		}
+		const BenchResult result = PRIV_RunScenario(scenario, frames);
+		PRIV_PrintResult(scenario, &result);
+		failures += result.failed ? 1 : 0;
+	}
+
+	if (gThreadCount > 1) {
+		PRIV_StopThreadPool(&gThreadPool);
+	}
+
+	return failures == 0 ? 0 : 1;
+}
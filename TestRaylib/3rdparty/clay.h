@@ -722,6 +722,84 @@ typedef struct Clay_RenderCommandArray {
     Clay_RenderCommand* internalArray;
 } Clay_RenderCommandArray;
 
+// Used by Clay_EndLayoutDiff to describe how a render command differs from the previous frame.
+typedef CLAY_PACKED_ENUM {
+    // The render command has no match in the previous frame.
+    CLAY_RENDER_COMMAND_DIFF_TYPE_ADDED,
+    // A render command from the previous frame has no match in this frame.
+    CLAY_RENDER_COMMAND_DIFF_TYPE_REMOVED,
+    // The render command exists in both frames, but its bounding box, z index or render data changed.
+    CLAY_RENDER_COMMAND_DIFF_TYPE_CHANGED,
+} Clay_RenderCommandDiffType;
+
+// A single entry of the difference between two frames, render commands are matched by (id, commandType).
+typedef struct Clay_RenderCommandDiff {
+    // The id of the render command, see Clay_RenderCommand.id
+    uint32_t id;
+    // The command type of the render command.
+    Clay_RenderCommandType commandType;
+    // Whether the command was added, removed or changed.
+    Clay_RenderCommandDiffType diffType;
+    // Index into Clay_LayoutDiff.renderCommands, or -1 for removed commands.
+    int32_t renderCommandIndex;
+    // The bounding box of the command in the previous frame. Zeroed for added commands.
+    Clay_BoundingBox previousBoundingBox;
+} Clay_RenderCommandDiff;
+
+// A sized array of Clay_RenderCommandDiff.
+typedef struct Clay_RenderCommandDiffArray {
+    int32_t capacity;
+    int32_t length;
+    Clay_RenderCommandDiff *internalArray;
+} Clay_RenderCommandDiffArray;
+
+// A sized array of Clay_BoundingBox.
+typedef struct Clay_BoundingBoxArray {
+    int32_t capacity;
+    int32_t length;
+    Clay_BoundingBox *internalArray;
+} Clay_BoundingBoxArray;
+
+// The result of Clay_EndLayoutDiff.
+typedef struct Clay_LayoutDiff {
+    // The full list of render commands for this frame, identical to the result of Clay_EndLayout.
+    Clay_RenderCommandArray renderCommands;
+    // Every render command that was added, removed or changed since the previous call to Clay_EndLayoutDiff.
+    Clay_RenderCommandDiffArray changes;
+    // A small set of non overlapping rectangles covering every pixel that may look different from the previous frame.
+    // Renderers that retain the previous frame only need to redraw these regions.
+    Clay_BoundingBoxArray damageRects;
+    // True when the previous frame can't be reused at all (first frame, resize, overflow).
+    // In that case damageRects contains a single rectangle covering the whole layout.
+    bool fullRedraw;
+} Clay_LayoutDiff;
+
+// Controls how long Clay keeps the measurements of text that is no longer on screen.
+typedef struct Clay_MeasureTextCachePolicy {
+    // Measurements not used for more than this many frames are dropped when Clay comes across them. 0 keeps them until space is needed.
+    uint32_t maxUnusedFrames;
+    // Upper bound in bytes for cached measurements, the least recently used ones are dropped to stay below it. 0 means no limit other than the capacity set with Clay_SetMaxMeasureTextCacheWordCount.
+    uint32_t byteBudget;
+    // Never drop the measurements of statically allocated strings (CLAY_STRING), they can't change so keeping them is always valid.
+    bool pinStaticStrings;
+} Clay_MeasureTextCachePolicy;
+
+// Counters of the text measurement cache, returned by Clay_GetMeasureTextCacheStats.
+typedef struct Clay_MeasureTextCacheStats {
+    // Text measurements found in the cache.
+    uint64_t hits;
+    // Text measurements that had to be computed, each one calls the measure text function once per word.
+    uint64_t misses;
+    // Calls made to the measure text function.
+    uint64_t measureTextCalls;
+    // Measurements dropped, either because they were unused for too long or to make room.
+    uint64_t evictions;
+    // Current contents of the cache.
+    int32_t entryCount;
+    int32_t wordCount;
+    uint32_t bytesUsed;
+} Clay_MeasureTextCacheStats;
+
 // Represents the current state of interaction with clay this frame.
 typedef CLAY_PACKED_ENUM {
     // A left mouse click, or touch occurred this frame.
@@ -862,6 +940,18 @@ CLAY_DLL_EXPORT void Clay_BeginLayout(void);
 // Called when all layout declarations are finished.
 // Computes the layout and generates and returns the array of render commands to draw.
 CLAY_DLL_EXPORT Clay_RenderCommandArray Clay_EndLayout(void);
+// Same as Clay_EndLayout, but also compares the render commands against those of the previous call to Clay_EndLayoutDiff.
+// Returns the added / removed / changed commands and a list of damage rectangles, so that a renderer retaining the
+// previous frame only has to redraw what actually changed. Use it consistently every frame, mixing with Clay_EndLayout skips frames.
+CLAY_DLL_EXPORT Clay_LayoutDiff Clay_EndLayoutDiff(void);
+// Returns true while a scroll container is still moving on its own, from momentum after a drag ended.
+// Hosts that only draw when something changed keep producing frames while it is.
+CLAY_DLL_EXPORT bool Clay_IsAnimating(void);
+// Returns true when a new layout could differ from the last one finished by Clay_EndLayout, for the reasons Clay can see:
+// a scroll container is animating or was scrolled, the set of elements under the pointer or the pointer button changed,
+// or the layout dimensions or debug mode changed. Call it after Clay_SetPointerState and Clay_UpdateScrollContainers.
+// Changes to the application's own state are invisible to Clay, hosts still lay out a frame for those.
+CLAY_DLL_EXPORT bool Clay_NeedsLayout(void);
 // Calculates a hash ID from the given idString.
 // Generally only used for dynamic strings when CLAY_ID("stringLiteral") can't be used.
 CLAY_DLL_EXPORT Clay_ElementId Clay_GetElementId(Clay_String idString);
@@ -897,6 +987,12 @@ CLAY_DLL_EXPORT void Clay_SetMeasureTextFunction(Clay_Dimensions (*measureTextFu
 // Experimental - Used in cases where Clay needs to integrate with a system that manages its own scrolling containers externally.
 // Please reach out if you plan to use this function, as it may be subject to change.
 CLAY_DLL_EXPORT void Clay_SetQueryScrollOffsetFunction(Clay_Vector2 (*queryScrollOffsetFunction)(uint32_t elementId, void *userData), void *userData);
+// Binds a job system that Clay can use to size independent layout trees (the root, floating elements, large subtrees) on several threads.
+// - parallelForFunction must call task(taskIndex, taskData) exactly once for every taskIndex in [0, taskCount), from any thread, and only return once all of them have finished.
+// - userData is a pointer that will be transparently passed through when the parallelForFunction is called.
+// Tasks never call the measure text function. The error handler may be called from a worker thread if an internal array overflows.
+// The result is identical to a single threaded layout. Pass NULL to go back to single threaded layout.
+CLAY_DLL_EXPORT void Clay_SetParallelForFunction(void (*parallelForFunction)(int32_t taskCount, void (*task)(int32_t taskIndex, void *taskData), void *taskData, void *userData), void *userData);
 // A bounds-checked "get" function for the Clay_RenderCommandArray returned from Clay_EndLayout().
 CLAY_DLL_EXPORT Clay_RenderCommand * Clay_RenderCommandArray_Get(Clay_RenderCommandArray* array, int32_t index);
 // Enables and disables Clay's internal debug tools.
@@ -906,11 +1002,23 @@ CLAY_DLL_EXPORT void Clay_SetDebugModeEnabled(bool enabled);
 CLAY_DLL_EXPORT bool Clay_IsDebugModeEnabled(void);
 // Enables and disables visibility culling. By default, Clay will not generate render commands for elements whose bounding box is entirely outside the screen.
 CLAY_DLL_EXPORT void Clay_SetCullingEnabled(bool enabled);
+// Enables and disables incremental layout. When enabled, subtrees whose declaration and available size are unchanged since
+// the previous frame reuse that frame's sizing results instead of being solved again. A frame that only differs from the previous
+// one in clip childOffsets, such as a scroll, skips sizing and text wrapping entirely and only positions and culls again. Disabled by default.
+// This state is retained and does not need to be set each frame, but should not be changed between Clay_BeginLayout() and Clay_EndLayout().
+CLAY_DLL_EXPORT void Clay_SetIncrementalLayoutEnabled(bool enabled);
 // Returns the maximum number of UI elements supported by Clay's current configuration.
 CLAY_DLL_EXPORT int32_t Clay_GetMaxElementCount(void);
 // Modifies the maximum number of UI elements supported by Clay's current configuration.
 // This may require reallocating additional memory, and re-calling Clay_Initialize();
 CLAY_DLL_EXPORT void Clay_SetMaxElementCount(int32_t maxElementCount);
+// Lets Clay grow its storage instead of failing when a layout needs more elements or text measurement words than it has capacity for.
+// At the start of a frame, if the previous frame used more than three quarters of a capacity or overflowed it, the capacity is doubled.
+// The larger arrays are placed in memory from allocateFunction, and the memory of a previous growth is released with freeFunction.
+// Persistent state (scroll positions, hover state, cached text measurements) is carried over, the Clay_Context pointer stays the same.
+CLAY_DLL_EXPORT void Clay_SetGrowFunctions(void *(*allocateFunction)(size_t size, void *userData), void (*freeFunction)(void *memory, void *userData), void *userData);
+// Releases the memory allocated through the grow functions. Call it before freeing the memory passed to Clay_Initialize, the context can't be used afterwards.
+CLAY_DLL_EXPORT void Clay_FreeGrownMemory(void);
 // Returns the maximum number of measured "words" (whitespace seperated runs of characters) that Clay can store in its internal text measurement cache.
 CLAY_DLL_EXPORT int32_t Clay_GetMaxMeasureTextCacheWordCount(void);
 // Modifies the maximum number of measured "words" (whitespace seperated runs of characters) that Clay can store in its internal text measurement cache.
@@ -918,6 +1026,12 @@ CLAY_DLL_EXPORT int32_t Clay_GetMaxMeasureTextCacheWordCount(void);
 CLAY_DLL_EXPORT void Clay_SetMaxMeasureTextCacheWordCount(int32_t maxMeasureTextCacheWordCount);
 // Resets Clay's internal text measurement cache. Useful if font mappings have changed or fonts have been reloaded.
 CLAY_DLL_EXPORT void Clay_ResetMeasureTextCache(void);
+// Sets how long text measurements are kept. The default drops measurements unused for more than 2 frames, with no byte budget and no pinning.
+CLAY_DLL_EXPORT void Clay_SetMeasureTextCachePolicy(Clay_MeasureTextCachePolicy policy);
+// Returns the hit / miss counters and current size of the text measurement cache.
+CLAY_DLL_EXPORT Clay_MeasureTextCacheStats Clay_GetMeasureTextCacheStats(void);
+// Sets the hits, misses, measureTextCalls and evictions counters back to zero.
+CLAY_DLL_EXPORT void Clay_ResetMeasureTextCacheStats(void);
 
 // Internal API functions required by macros ----------------------
 
@@ -1071,8 +1185,14 @@ bool Clay__Array_AddCapacityCheck(int32_t length, int32_t capacity);
 
 CLAY__ARRAY_DEFINE(bool, Clay__boolArray)
 CLAY__ARRAY_DEFINE(int32_t, Clay__int32_tArray)
+CLAY__ARRAY_DEFINE(uint32_t, Clay__uint32_tArray)
 CLAY__ARRAY_DEFINE(char, Clay__charArray)
+CLAY__ARRAY_DEFINE(float, Clay__floatArray)
+CLAY__ARRAY_DEFINE(uint8_t, Clay__uint8_tArray)
+CLAY__ARRAY_DEFINE(Clay__SizingType, Clay__SizingTypeArray)
 CLAY__ARRAY_DEFINE_FUNCTIONS(Clay_ElementId, Clay_ElementIdArray)
+CLAY__ARRAY_DEFINE_FUNCTIONS(Clay_RenderCommandDiff, Clay_RenderCommandDiffArray)
+CLAY__ARRAY_DEFINE_FUNCTIONS(Clay_BoundingBox, Clay_BoundingBoxArray)
 CLAY__ARRAY_DEFINE(Clay_LayoutConfig, Clay__LayoutConfigArray)
 CLAY__ARRAY_DEFINE(Clay_TextElementConfig, Clay__TextElementConfigArray)
 CLAY__ARRAY_DEFINE(Clay_AspectRatioElementConfig, Clay__AspectRatioElementConfigArray)
@@ -1122,6 +1242,15 @@ typedef struct {
 
 CLAY__ARRAY_DEFINE(Clay__WrappedTextLine, Clay__WrappedTextLineArray)
 
+// A wrapped line kept across frames, stored as an offset into its text element's string as the string itself may not outlive the frame
+typedef struct {
+    Clay_Dimensions dimensions;
+    int32_t startOffset;
+    int32_t length;
+} Clay__CachedWrappedTextLine;
+
+CLAY__ARRAY_DEFINE(Clay__CachedWrappedTextLine, Clay__CachedWrappedTextLineArray)
+
 typedef struct {
     Clay_String text;
     Clay_Dimensions preferredDimensions;
@@ -1161,6 +1290,8 @@ typedef struct {
     Clay_Vector2 scrollPosition;
     Clay_Vector2 previousDelta;
     float momentumTime;
+    // scrollPosition when the last layout was finished, see Clay_NeedsLayout
+    Clay_Vector2 layoutScrollPosition;
     uint32_t elementId;
     bool openThisFrame;
     bool pointerScrollActive;
@@ -1173,21 +1304,38 @@ typedef struct {
     bool collapsed;
 } Clay__DebugElementData;
 
-CLAY__ARRAY_DEFINE(Clay__DebugElementData, Clay__DebugElementDataArray)
-
-typedef struct { // todo get this struct into a single cache line
+// Data read by layout, hit testing and id lookups every frame, kept to 48 bytes so reading an item touches one or two cache lines
+// instead of two or three. Everything else lives in Clay__LayoutElementHashMapItemCold at the same index.
+typedef struct {
     Clay_BoundingBox boundingBox;
-    Clay_ElementId elementId;
     Clay_LayoutElement* layoutElement;
-    void (*onHoverFunction)(Clay_ElementId elementId, Clay_PointerData pointerInfo, void *userData);
-    void *hoverFunctionUserData;
-    int32_t nextIndex;
+    uint32_t id;
     uint32_t generation;
-    Clay__DebugElementData *debugData;
+    // Incremental layout - hash of the element's subtree and its final dimensions from the last frame it was laid out
+    uint32_t layoutHash;
+    Clay_Dimensions layoutDimensions;
 } Clay_LayoutElementHashMapItem;
 
 CLAY__ARRAY_DEFINE(Clay_LayoutElementHashMapItem, Clay__LayoutElementHashMapItemArray)
 
+// Data only read when the pointer is over an element or by the debug view, see Clay__GetHashMapItemCold
+typedef struct {
+    Clay_ElementId elementId;
+    void (*onHoverFunction)(Clay_ElementId elementId, Clay_PointerData pointerInfo, void *userData);
+    void *hoverFunctionUserData;
+    Clay__DebugElementData debugData;
+} Clay__LayoutElementHashMapItemCold;
+
+CLAY__ARRAY_DEFINE(Clay__LayoutElementHashMapItemCold, Clay__LayoutElementHashMapItemColdArray)
+
+// Open addressing slot of the element hash map, an id of 0 marks an empty slot
+typedef struct {
+    uint32_t id;
+    int32_t itemIndex;
+} Clay__LayoutElementHashMapSlot;
+
+CLAY__ARRAY_DEFINE(Clay__LayoutElementHashMapSlot, Clay__LayoutElementHashMapSlotArray)
+
 typedef struct {
     int32_t startOffset;
     int32_t length;
@@ -1206,6 +1354,10 @@ typedef struct {
     uint32_t id;
     int32_t nextIndex;
     uint32_t generation;
+    // Least recently used list, item 0 is the list head. Pinned items are never in the list.
+    int32_t lruPrevious;
+    int32_t lruNext;
+    bool pinned;
 } Clay__MeasureTextCacheItem;
 
 CLAY__ARRAY_DEFINE(Clay__MeasureTextCacheItem, Clay__MeasureTextCacheItemArray)
@@ -1228,6 +1380,87 @@ typedef struct {
 
 CLAY__ARRAY_DEFINE(Clay__LayoutElementTreeRoot, Clay__LayoutElementTreeRootArray)
 
+// Compact copy of a render command kept across frames by Clay_EndLayoutDiff.
+// Render data is stored as a hash, as text and user pointers may not outlive the frame.
+typedef struct {
+    Clay_BoundingBox boundingBox;
+    uint32_t id;
+    uint32_t contentHash;
+    Clay_RenderCommandType commandType;
+    bool matched;
+} Clay__RenderCommandSnapshot;
+
+CLAY__ARRAY_DEFINE(Clay__RenderCommandSnapshot, Clay__RenderCommandSnapshotArray)
+
+#define CLAY__MAX_DAMAGE_RECT_COUNT 16
+
+// One element as seen by pointer hit testing, in the order Clay_SetPointerState reports them (topmost root first, then depth first)
+typedef struct {
+    Clay_BoundingBox boundingBox; // Already offset by the root's pointerOffset
+    Clay_BoundingBox clipBoundingBox;
+    Clay_LayoutElementHashMapItem *hashMapItem;
+    int32_t rootIndex;
+    bool clipped;
+} Clay__PointerIndexEntry;
+
+CLAY__ARRAY_DEFINE(Clay__PointerIndexEntry, Clay__PointerIndexEntryArray)
+
+// Bounding volume hierarchy node over pointer index entries
+typedef struct {
+    // Stored as extents rather than a bounding box, so the containment test compares exactly the values its entries do
+    Clay_Vector2 min;
+    Clay_Vector2 max;
+    int32_t firstIndex; // Leaf: first position in pointerIndexOrder. Internal: index of the left child, the right child follows it
+    int32_t count; // Leaf: number of entries. Internal: 0
+} Clay__PointerIndexNode;
+
+CLAY__ARRAY_DEFINE(Clay__PointerIndexNode, Clay__PointerIndexNodeArray)
+
+#define CLAY__POINTER_INDEX_LEAF_SIZE 4
+
+// Work for one parallel layout task, either a run of small consecutive tree roots or a single subtree of a large root.
+// Each task sizes its elements with its own slice of the shared scratch buffers.
+typedef struct {
+    int32_t treeRootIndex;
+    int32_t treeRootCount; // 0 when the task is the subtree at layoutElementIndex
+    int32_t layoutElementIndex;
+    int32_t elementCount;
+    int32_t bufferOffset;
+    int32_t bufferCapacity;
+} Clay__SizingTask;
+
+CLAY__ARRAY_DEFINE(Clay__SizingTask, Clay__SizingTaskArray)
+
+// What the sizing passes read from an element along one axis, copied out of the elements and their configs into one array per field,
+// indexed by layout element. Filled as each element closes, see Clay__StageLayoutElementSizing.
+typedef struct {
+    // The sizes being calculated, written back to the elements once sizing is done, see Clay__StoreStagedSizes
+    Clay__floatArray sizes;
+    Clay__floatArray minSizes;
+    // Holds the percentage for CLAY__SIZING_TYPE_PERCENT elements, like Clay_SizingAxis
+    Clay__floatArray maxSizes;
+    Clay__SizingTypeArray sizingTypes;
+} Clay__SizingAxisStaging;
+
+// Bits of Clay_Context.layoutElementSizingFlags
+// The element is a container with children, so it is queued to size them
+#define CLAY__SIZING_FLAG_HAS_CHILDREN 1
+// The element is neither fixed nor percent sized nor unwrapped text, so its parent may grow or compress it along that axis
+#define CLAY__SIZING_FLAG_RESIZABLE_X 2
+#define CLAY__SIZING_FLAG_RESIZABLE_Y 4
+// The element clips its children along that axis, which keeps them from being compressed
+#define CLAY__SIZING_FLAG_CLIP_X 8
+#define CLAY__SIZING_FLAG_CLIP_Y 16
+#define CLAY__SIZING_FLAG_ASPECT 32
+// The element is floating, so it is the root of its own tree rather than a child of the element it was declared in
+#define CLAY__SIZING_FLAG_FLOATING 64
+
+// Roots with at least this many elements are split into subtrees, until about CLAY__PARALLEL_SPLIT_TASK_COUNT of them are waiting
+#define CLAY__PARALLEL_SPLIT_MIN_ELEMENTS 512
+#define CLAY__PARALLEL_SPLIT_TASK_COUNT 32
+// Smaller roots are grouped with the roots after them until a task holds about this many elements
+#define CLAY__PARALLEL_TASK_MIN_ELEMENTS 256
+
 struct Clay_Context {
     int32_t maxElementCount;
     int32_t maxMeasureTextCacheWordCount;
@@ -1243,11 +1476,20 @@ struct Clay_Context {
     bool debugModeEnabled;
     bool disableCulling;
     bool externalScrollHandlingEnabled;
+    bool incrementalLayoutEnabled;
+    Clay_MeasureTextCachePolicy measureTextCachePolicy;
+    Clay_MeasureTextCacheStats measureTextCacheStats;
     uint32_t debugSelectedElementId;
     uint32_t generation;
     uintptr_t arenaResetOffset;
     void *measureTextUserData;
     void *queryScrollOffsetUserData;
+    void (*parallelForFunction)(int32_t taskCount, void (*task)(int32_t taskIndex, void *taskData), void *taskData, void *userData);
+    void *parallelForUserData;
+    void *(*growAllocateFunction)(size_t size, void *userData);
+    void (*growFreeFunction)(void *memory, void *userData);
+    void *growUserData;
+    void *grownMemory;
     Clay_Arena internalArena;
     // Layout Elements / Render Commands
     Clay_LayoutElementArray layoutElements;
@@ -1259,6 +1501,12 @@ struct Clay_Context {
     Clay__int32_tArray aspectRatioElementIndexes;
     Clay__int32_tArray reusableElementIndexBuffer;
     Clay__int32_tArray layoutElementClipElementIds;
+    Clay__int32_tArray layoutElementHashMapItemIndexes;
+    Clay__uint32_tArray layoutElementLayoutHashes;
+    // Incremental layout - the last full layout's tree hash and wrapped text lines, see Clay__ReuseLastLayoutSizes
+    uint32_t cachedLayoutTreeHash;
+    Clay__CachedWrappedTextLineArray cachedWrappedTextLines;
+    Clay__int32_tArray cachedWrappedTextLineCounts;
     // Configs
     Clay__LayoutConfigArray layoutConfigs;
     Clay__ElementConfigArray elementConfigs;
@@ -1275,8 +1523,12 @@ struct Clay_Context {
     Clay__WrappedTextLineArray wrappedTextLines;
     Clay__LayoutElementTreeNodeArray layoutElementTreeNodeArray1;
     Clay__LayoutElementTreeRootArray layoutElementTreeRoots;
+    Clay__LayoutElementTreeRootArray layoutElementTreeRootsSortBuffer;
     Clay__LayoutElementHashMapItemArray layoutElementsHashMapInternal;
-    Clay__int32_tArray layoutElementsHashMap;
+    // Parallel to layoutElementsHashMapInternal
+    Clay__LayoutElementHashMapItemColdArray layoutElementsHashMapCold;
+    // Robin hood probed slots over layoutElementsHashMapInternal, probing only compares ids and never touches the items
+    Clay__LayoutElementHashMapSlotArray layoutElementsHashMap;
     Clay__MeasureTextCacheItemArray measureTextHashMapInternal;
     Clay__int32_tArray measureTextHashMapInternalFreeList;
     Clay__int32_tArray measureTextHashMap;
@@ -1287,7 +1539,39 @@ struct Clay_Context {
     Clay__ScrollContainerDataInternalArray scrollContainerDatas;
     Clay__boolArray treeNodeVisited;
     Clay__charArray dynamicStringData;
-    Clay__DebugElementDataArray debugElementData;
+    // Render command diffing
+    bool renderCommandSnapshotsValid;
+    Clay_Dimensions renderCommandSnapshotDimensions;
+    Clay__RenderCommandSnapshotArray renderCommandSnapshots;
+    Clay__RenderCommandSnapshotArray previousRenderCommandSnapshots;
+    Clay__int32_tArray renderCommandSnapshotLookup;
+    Clay_RenderCommandDiffArray renderCommandDiffs;
+    Clay_BoundingBoxArray damageRects;
+    // What the last finished layout was computed with, see Clay_NeedsLayout
+    bool lastLayoutValid;
+    Clay_Dimensions lastLayoutDimensions;
+    uint32_t lastLayoutPointerOverHash;
+    bool lastLayoutDebugModeEnabled;
+    // Pointer hit testing, built from the last finished layout on the first Clay_SetPointerState call
+    bool pointerIndexAvailable;
+    bool pointerIndexBuilt;
+    Clay__PointerIndexEntryArray pointerIndexEntries;
+    Clay__PointerIndexNodeArray pointerIndexNodes;
+    Clay__int32_tArray pointerIndexOrder;
+    Clay__int32_tArray pointerIndexStack;
+    Clay__int32_tArray pointerIndexHits;
+    // Parallel layout
+    Clay__int32_tArray layoutElementTreeSizes;
+    Clay__int32_tArray layoutElementRootIndexes;
+    Clay__SizingTaskArray sizingTasks;
+    // Sizing passes, [0] is the x axis and [1] the y axis
+    Clay__SizingAxisStaging sizingStaging[2];
+    Clay__uint8_tArray layoutElementSizingFlags;
+    // Elements are stored in declaration order, so every element is followed by the elements declared inside it.
+    // Element i's subtree is [i, i + layoutElementSubtreeSizes[i]), floating elements declared inside it included.
+    Clay__int32_tArray layoutElementSubtreeSizes;
+    // Scratch space of the grow and shrink passes, see Clay__DistributeSizeToChildren
+    Clay__int32_tArray resizableLimitBuffer;
 };
 
 Clay_Context* Clay__Context_Allocate_Arena(Clay_Arena *arena) {
@@ -1564,13 +1848,93 @@ Clay__MeasuredWord *Clay__AddMeasuredWord(Clay__MeasuredWord word, Clay__Measure
         context->measuredWordsFreeList.length--;
         Clay__MeasuredWordArray_Set(&context->measuredWords, (int)newItemIndex, word);
         previousWord->next = (int32_t)newItemIndex;
+        context->measureTextCacheStats.wordCount++;
         return Clay__MeasuredWordArray_Get(&context->measuredWords, (int)newItemIndex);
     } else {
         previousWord->next = (int32_t)context->measuredWords.length;
+        context->measureTextCacheStats.wordCount++;
         return Clay__MeasuredWordArray_Add(&context->measuredWords, word);
     }
 }
 
+void Clay__MeasureTextCacheLruUnlink(int32_t itemIndex) {
+    Clay__MeasureTextCacheItem *items = Clay_GetCurrentContext()->measureTextHashMapInternal.internalArray;
+    items[items[itemIndex].lruPrevious].lruNext = items[itemIndex].lruNext;
+    items[items[itemIndex].lruNext].lruPrevious = items[itemIndex].lruPrevious;
+}
+
+void Clay__MeasureTextCacheLruPushFront(int32_t itemIndex) {
+    Clay__MeasureTextCacheItem *items = Clay_GetCurrentContext()->measureTextHashMapInternal.internalArray;
+    items[itemIndex].lruPrevious = 0;
+    items[itemIndex].lruNext = items[0].lruNext;
+    items[items[0].lruNext].lruPrevious = itemIndex;
+    items[0].lruNext = itemIndex;
+}
+
+void Clay__ResetMeasureTextCacheLru(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    context->measureTextHashMapInternal.internalArray[0] = CLAY__INIT(Clay__MeasureTextCacheItem) { .measuredWordsStartIndex = -1 };
+    context->measureTextCacheStats.entryCount = 0;
+    context->measureTextCacheStats.wordCount = 0;
+}
+
+// Releases a cache item and its measured words, returns the item that followed it in its hash bucket
+int32_t Clay__RemoveMeasureTextCacheItem(int32_t elementIndex, int32_t elementIndexPrevious, uint32_t hashBucket) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay__MeasureTextCacheItem *hashEntry = Clay__MeasureTextCacheItemArray_Get(&context->measureTextHashMapInternal, elementIndex);
+    // Add all the measured words that were included in this measurement to the freelist
+    int32_t nextWordIndex = hashEntry->measuredWordsStartIndex;
+    while (nextWordIndex != -1) {
+        Clay__MeasuredWord *measuredWord = Clay__MeasuredWordArray_Get(&context->measuredWords, nextWordIndex);
+        Clay__int32_tArray_Add(&context->measuredWordsFreeList, nextWordIndex);
+        context->measureTextCacheStats.wordCount--;
+        nextWordIndex = measuredWord->next;
+    }
+    if (!hashEntry->pinned) {
+        Clay__MeasureTextCacheLruUnlink(elementIndex);
+    }
+
+    int32_t nextIndex = hashEntry->nextIndex;
+    Clay__MeasureTextCacheItemArray_Set(&context->measureTextHashMapInternal, elementIndex, CLAY__INIT(Clay__MeasureTextCacheItem) { .measuredWordsStartIndex = -1 });
+    Clay__int32_tArray_Add(&context->measureTextHashMapInternalFreeList, elementIndex);
+    if (elementIndexPrevious == 0) {
+        context->measureTextHashMap.internalArray[hashBucket] = nextIndex;
+    } else {
+        Clay__MeasureTextCacheItem *previousHashEntry = Clay__MeasureTextCacheItemArray_Get(&context->measureTextHashMapInternal, elementIndexPrevious);
+        previousHashEntry->nextIndex = nextIndex;
+    }
+    context->measureTextCacheStats.entryCount--;
+    context->measureTextCacheStats.evictions++;
+    return nextIndex;
+}
+
+// Drops the least recently used measurement, unless it was used this frame and may still be referenced by the layout
+bool Clay__EvictLeastRecentlyUsedMeasurement(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    int32_t itemIndex = context->measureTextHashMapInternal.internalArray[0].lruPrevious;
+    if (itemIndex == 0) {
+        return false;
+    }
+    Clay__MeasureTextCacheItem *item = Clay__MeasureTextCacheItemArray_Get(&context->measureTextHashMapInternal, itemIndex);
+    if (item->generation == context->generation) {
+        return false;
+    }
+    uint32_t hashBucket = item->id % (context->maxMeasureTextCacheWordCount / 32);
+    int32_t elementIndexPrevious = 0;
+    int32_t elementIndex = context->measureTextHashMap.internalArray[hashBucket];
+    while (elementIndex != itemIndex) {
+        elementIndexPrevious = elementIndex;
+        elementIndex = context->measureTextHashMapInternal.internalArray[elementIndex].nextIndex;
+    }
+    Clay__RemoveMeasureTextCacheItem(itemIndex, elementIndexPrevious, hashBucket);
+    return true;
+}
+
+uint32_t Clay__MeasureTextCacheBytesUsed(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    return (uint32_t)(context->measureTextCacheStats.entryCount * sizeof(Clay__MeasureTextCacheItem) + context->measureTextCacheStats.wordCount * sizeof(Clay__MeasuredWord));
+}
+
 Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_TextElementConfig *config) {
     Clay_Context* context = Clay_GetCurrentContext();
     #ifndef CLAY_WASM
@@ -1592,37 +1956,41 @@ Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_Text
     while (elementIndex != 0) {
         Clay__MeasureTextCacheItem *hashEntry = Clay__MeasureTextCacheItemArray_Get(&context->measureTextHashMapInternal, elementIndex);
         if (hashEntry->id == id) {
+            // The list only needs to be ordered by frame, so an item moves to the front once per frame at most
+            if (!hashEntry->pinned && hashEntry->generation != context->generation) {
+                Clay__MeasureTextCacheLruUnlink(elementIndex);
+                Clay__MeasureTextCacheLruPushFront(elementIndex);
+            }
             hashEntry->generation = context->generation;
+            context->measureTextCacheStats.hits++;
             return hashEntry;
         }
         // This element hasn't been seen in a few frames, delete the hash map item
-        if (context->generation - hashEntry->generation > 2) {
-            // Add all the measured words that were included in this measurement to the freelist
-            int32_t nextWordIndex = hashEntry->measuredWordsStartIndex;
-            while (nextWordIndex != -1) {
-                Clay__MeasuredWord *measuredWord = Clay__MeasuredWordArray_Get(&context->measuredWords, nextWordIndex);
-                Clay__int32_tArray_Add(&context->measuredWordsFreeList, nextWordIndex);
-                nextWordIndex = measuredWord->next;
-            }
-
-            int32_t nextIndex = hashEntry->nextIndex;
-            Clay__MeasureTextCacheItemArray_Set(&context->measureTextHashMapInternal, elementIndex, CLAY__INIT(Clay__MeasureTextCacheItem) { .measuredWordsStartIndex = -1 });
-            Clay__int32_tArray_Add(&context->measureTextHashMapInternalFreeList, elementIndex);
-            if (elementIndexPrevious == 0) {
-                context->measureTextHashMap.internalArray[hashBucket] = nextIndex;
-            } else {
-                Clay__MeasureTextCacheItem *previousHashEntry = Clay__MeasureTextCacheItemArray_Get(&context->measureTextHashMapInternal, elementIndexPrevious);
-                previousHashEntry->nextIndex = nextIndex;
-            }
-            elementIndex = nextIndex;
+        uint32_t maxUnusedFrames = context->measureTextCachePolicy.maxUnusedFrames;
+        if (maxUnusedFrames > 0 && !hashEntry->pinned && context->generation - hashEntry->generation > maxUnusedFrames) {
+            elementIndex = Clay__RemoveMeasureTextCacheItem(elementIndex, elementIndexPrevious, hashBucket);
         } else {
             elementIndexPrevious = elementIndex;
             elementIndex = hashEntry->nextIndex;
         }
     }
 
+    context->measureTextCacheStats.misses++;
+    // Make room from older measurements before running out, a text can't produce more words than it has characters plus one
+    if (context->measureTextHashMapInternalFreeList.length == 0 && context->measureTextHashMapInternal.length == context->measureTextHashMapInternal.capacity - 1) {
+        Clay__EvictLeastRecentlyUsedMeasurement();
+    }
+    while ((context->measuredWords.capacity - 1 - context->measuredWords.length) + context->measuredWordsFreeList.length < text->length + 1 && Clay__EvictLeastRecentlyUsedMeasurement()) {}
+    // Evicting may have unlinked items from this bucket, including the one the new item will be linked after
+    elementIndexPrevious = 0;
+    elementIndex = context->measureTextHashMap.internalArray[hashBucket];
+    while (elementIndex != 0) {
+        elementIndexPrevious = elementIndex;
+        elementIndex = context->measureTextHashMapInternal.internalArray[elementIndex].nextIndex;
+    }
+
     int32_t newItemIndex = 0;
-    Clay__MeasureTextCacheItem newCacheItem = { .measuredWordsStartIndex = -1, .id = id, .generation = context->generation };
+    Clay__MeasureTextCacheItem newCacheItem = { .measuredWordsStartIndex = -1, .id = id, .generation = context->generation, .pinned = context->measureTextCachePolicy.pinStaticStrings && text->isStaticallyAllocated };
     Clay__MeasureTextCacheItem *measured = NULL;
     if (context->measureTextHashMapInternalFreeList.length > 0) {
         newItemIndex = Clay__int32_tArray_GetValue(&context->measureTextHashMapInternalFreeList, context->measureTextHashMapInternalFreeList.length - 1);
@@ -1650,6 +2018,7 @@ Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_Text
     float measuredWidth = 0;
     float measuredHeight = 0;
     float spaceWidth = Clay__MeasureText(CLAY__INIT(Clay_StringSlice) { .length = 1, .chars = CLAY__SPACECHAR.chars, .baseChars = CLAY__SPACECHAR.chars }, config, context->measureTextUserData).width;
+    context->measureTextCacheStats.measureTextCalls++;
     Clay__MeasuredWord tempWord = { .next = -1 };
     Clay__MeasuredWord *previousWord = &tempWord;
     while (end < text->length) {
@@ -1669,6 +2038,7 @@ Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_Text
             Clay_Dimensions dimensions = CLAY__DEFAULT_STRUCT;
             if (length > 0) {
                 dimensions = Clay__MeasureText(CLAY__INIT(Clay_StringSlice) {.length = length, .chars = &text->chars[start], .baseChars = text->chars}, config, context->measureTextUserData);
+                context->measureTextCacheStats.measureTextCalls++;
             }
             measured->minWidth = CLAY__MAX(dimensions.width, measured->minWidth);
             measuredHeight = CLAY__MAX(measuredHeight, dimensions.height);
@@ -1693,6 +2063,7 @@ Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_Text
     }
     if (end - start > 0) {
         Clay_Dimensions dimensions = Clay__MeasureText(CLAY__INIT(Clay_StringSlice) { .length = end - start, .chars = &text->chars[start], .baseChars = text->chars }, config, context->measureTextUserData);
+        context->measureTextCacheStats.measureTextCalls++;
         Clay__AddMeasuredWord(CLAY__INIT(Clay__MeasuredWord) { .startOffset = start, .length = end - start, .width = dimensions.width, .next = -1 }, previousWord);
         lineWidth += dimensions.width;
         measuredHeight = CLAY__MAX(measuredHeight, dimensions.height);
@@ -1709,6 +2080,12 @@ Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_Text
     } else {
         context->measureTextHashMap.internalArray[hashBucket] = newItemIndex;
     }
+    if (!measured->pinned) {
+        Clay__MeasureTextCacheLruPushFront(newItemIndex);
+    }
+    context->measureTextCacheStats.entryCount++;
+    uint32_t byteBudget = context->measureTextCachePolicy.byteBudget;
+    while (byteBudget > 0 && Clay__MeasureTextCacheBytesUsed() > byteBudget && Clay__EvictLeastRecentlyUsedMeasurement()) {}
     return measured;
 }
 
@@ -1716,62 +2093,110 @@ bool Clay__PointIsInsideRect(Clay_Vector2 point, Clay_BoundingBox rect) {
     return point.x >= rect.x && point.x <= rect.x + rect.width && point.y >= rect.y && point.y <= rect.y + rect.height;
 }
 
-Clay_LayoutElementHashMapItem* Clay__AddHashMapItem(Clay_ElementId elementId, Clay_LayoutElement* layoutElement) {
+// Returns the index of the item with this id in layoutElementsHashMapInternal, or -1.
+// Slots are kept ordered by distance from their home slot, so a miss stops at the first slot closer to home than the probe.
+int32_t Clay__FindHashMapItemIndex(uint32_t id) {
     Clay_Context* context = Clay_GetCurrentContext();
-    if (context->layoutElementsHashMapInternal.length == context->layoutElementsHashMapInternal.capacity - 1) {
-        return NULL;
+    if (id == 0) {
+        return -1;
     }
-    Clay_LayoutElementHashMapItem item = { .elementId = elementId, .layoutElement = layoutElement, .nextIndex = -1, .generation = context->generation + 1 };
-    uint32_t hashBucket = elementId.id % context->layoutElementsHashMap.capacity;
-    int32_t hashItemPrevious = -1;
-    int32_t hashItemIndex = context->layoutElementsHashMap.internalArray[hashBucket];
-    while (hashItemIndex != -1) { // Just replace collision, not a big deal - leave it up to the end user
+    const Clay__LayoutElementHashMapSlot *slots = context->layoutElementsHashMap.internalArray;
+    uint32_t mask = (uint32_t)context->layoutElementsHashMap.capacity - 1;
+    uint32_t slot = id & mask;
+    for (uint32_t distance = 0;; ++distance) {
+        uint32_t slotId = slots[slot].id;
+        if (slotId == id) {
+            return slots[slot].itemIndex;
+        }
+        if (slotId == 0 || ((slot - slotId) & mask) < distance) {
+            return -1;
+        }
+        slot = (slot + 1) & mask;
+    }
+}
+
+// Inserts an id that isn't in the map yet, taking the slot of any id that is closer to its home slot and moving that one further along
+void Clay__InsertHashMapSlot(uint32_t id, int32_t itemIndex) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay__LayoutElementHashMapSlot *slots = context->layoutElementsHashMap.internalArray;
+    Clay__LayoutElementHashMapSlot inserted = { .id = id, .itemIndex = itemIndex };
+    uint32_t mask = (uint32_t)context->layoutElementsHashMap.capacity - 1;
+    uint32_t slot = id & mask;
+    for (uint32_t distance = 0;; ++distance) {
+        Clay__LayoutElementHashMapSlot resident = slots[slot];
+        if (resident.id == 0) {
+            slots[slot] = inserted;
+            return;
+        }
+        uint32_t residentDistance = (slot - resident.id) & mask;
+        if (residentDistance < distance) {
+            slots[slot] = inserted;
+            inserted = resident;
+            distance = residentDistance;
+        }
+        slot = (slot + 1) & mask;
+    }
+}
+
+Clay_LayoutElementHashMapItem* Clay__AddHashMapItem(Clay_ElementId elementId, Clay_LayoutElement* layoutElement) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    int32_t hashItemIndex = Clay__FindHashMapItemIndex(elementId.id);
+    if (hashItemIndex != -1) { // Collision - resolve based on generation
         Clay_LayoutElementHashMapItem *hashItem = Clay__LayoutElementHashMapItemArray_Get(&context->layoutElementsHashMapInternal, hashItemIndex);
-        if (hashItem->elementId.id == elementId.id) { // Collision - resolve based on generation
-            item.nextIndex = hashItem->nextIndex;
-            if (hashItem->generation <= context->generation) { // First collision - assume this is the "same" element
-                hashItem->elementId = elementId; // Make sure to copy this across. If the stringId reference has changed, we should update the hash item to use the new one.
-                hashItem->generation = context->generation + 1;
-                hashItem->layoutElement = layoutElement;
-                hashItem->debugData->collision = false;
-                hashItem->onHoverFunction = NULL;
-                hashItem->hoverFunctionUserData = 0;
-            } else { // Multiple collisions this frame - two elements have the same ID
-                context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
-                    .errorType = CLAY_ERROR_TYPE_DUPLICATE_ID,
-                    .errorText = CLAY_STRING("An element with this ID was already previously declared during this layout."),
-                    .userData = context->errorHandler.userData });
-                if (context->debugModeEnabled) {
-                    hashItem->debugData->collision = true;
-                }
+        Clay__LayoutElementHashMapItemCold *coldItem = Clay__LayoutElementHashMapItemColdArray_Get(&context->layoutElementsHashMapCold, hashItemIndex);
+        if (hashItem->generation <= context->generation) { // First collision - assume this is the "same" element
+            coldItem->elementId = elementId; // Make sure to copy this across. If the stringId reference has changed, we should update the hash item to use the new one.
+            hashItem->generation = context->generation + 1;
+            hashItem->layoutElement = layoutElement;
+            coldItem->debugData.collision = false;
+            coldItem->onHoverFunction = NULL;
+            coldItem->hoverFunctionUserData = 0;
+        } else { // Multiple collisions this frame - two elements have the same ID
+            context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+                .errorType = CLAY_ERROR_TYPE_DUPLICATE_ID,
+                .errorText = CLAY_STRING("An element with this ID was already previously declared during this layout."),
+                .userData = context->errorHandler.userData });
+            if (context->debugModeEnabled) {
+                coldItem->debugData.collision = true;
             }
-            return hashItem;
         }
-        hashItemPrevious = hashItemIndex;
-        hashItemIndex = hashItem->nextIndex;
+        return hashItem;
     }
-    Clay_LayoutElementHashMapItem *hashItem = Clay__LayoutElementHashMapItemArray_Add(&context->layoutElementsHashMapInternal, item);
-    hashItem->debugData = Clay__DebugElementDataArray_Add(&context->debugElementData, CLAY__INIT(Clay__DebugElementData) CLAY__DEFAULT_STRUCT);
-    if (hashItemPrevious != -1) {
-        Clay__LayoutElementHashMapItemArray_Get(&context->layoutElementsHashMapInternal, hashItemPrevious)->nextIndex = (int32_t)context->layoutElementsHashMapInternal.length - 1;
-    } else {
-        context->layoutElementsHashMap.internalArray[hashBucket] = (int32_t)context->layoutElementsHashMapInternal.length - 1;
+    // The id 0 marks empty slots, it is only produced by a hash overflowing and can't be stored
+    if (context->layoutElementsHashMapInternal.length == context->layoutElementsHashMapInternal.capacity - 1 || elementId.id == 0) {
+        return NULL;
     }
+    Clay_LayoutElementHashMapItem item = { .layoutElement = layoutElement, .id = elementId.id, .generation = context->generation + 1 };
+    Clay_LayoutElementHashMapItem *hashItem = Clay__LayoutElementHashMapItemArray_Add(&context->layoutElementsHashMapInternal, item);
+    Clay__LayoutElementHashMapItemColdArray_Add(&context->layoutElementsHashMapCold, CLAY__INIT(Clay__LayoutElementHashMapItemCold) { .elementId = elementId });
+    Clay__InsertHashMapSlot(elementId.id, (int32_t)context->layoutElementsHashMapInternal.length - 1);
     return hashItem;
 }
 
 Clay_LayoutElementHashMapItem *Clay__GetHashMapItem(uint32_t id) {
     Clay_Context* context = Clay_GetCurrentContext();
-    uint32_t hashBucket = id % context->layoutElementsHashMap.capacity;
-    int32_t elementIndex = context->layoutElementsHashMap.internalArray[hashBucket];
-    while (elementIndex != -1) {
-        Clay_LayoutElementHashMapItem *hashEntry = Clay__LayoutElementHashMapItemArray_Get(&context->layoutElementsHashMapInternal, elementIndex);
-        if (hashEntry->elementId.id == id) {
-            return hashEntry;
-        }
-        elementIndex = hashEntry->nextIndex;
+    int32_t itemIndex = Clay__FindHashMapItemIndex(id);
+    if (itemIndex == -1) {
+        return &Clay_LayoutElementHashMapItem_DEFAULT;
+    }
+    return &context->layoutElementsHashMapInternal.internalArray[itemIndex];
+}
+
+// Returns the cold half of an item returned by Clay__GetHashMapItem or Clay__AddHashMapItem
+Clay__LayoutElementHashMapItemCold *Clay__GetHashMapItemCold(Clay_LayoutElementHashMapItem *item) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (!item || item == &Clay_LayoutElementHashMapItem_DEFAULT) {
+        return &Clay__LayoutElementHashMapItemCold_DEFAULT;
     }
-    return &Clay_LayoutElementHashMapItem_DEFAULT;
+    return Clay__LayoutElementHashMapItemColdArray_Get(&context->layoutElementsHashMapCold, (int32_t)(item - context->layoutElementsHashMapInternal.internalArray));
+}
+
+// Remembers which hash map item belongs to a layout element, so incremental layout can find last frame's results without a lookup
+void Clay__StoreLayoutElementHashMapItemIndex(Clay_LayoutElement *layoutElement, Clay_LayoutElementHashMapItem *hashMapItem) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    // Duplicate IDs leave the hash map item pointing at the first element, the second one simply doesn't get cached
+    int32_t hashMapItemIndex = hashMapItem && hashMapItem->layoutElement == layoutElement ? (int32_t)(hashMapItem - context->layoutElementsHashMapInternal.internalArray) : -1;
+    Clay__int32_tArray_Set(&context->layoutElementHashMapItemIndexes, (int32_t)(layoutElement - context->layoutElements.internalArray), hashMapItemIndex);
 }
 
 Clay_ElementId Clay__GenerateIdForAnonymousElement(Clay_LayoutElement *openLayoutElement) {
@@ -1780,7 +2205,10 @@ Clay_ElementId Clay__GenerateIdForAnonymousElement(Clay_LayoutElement *openLayou
     uint32_t offset = parentElement->childrenOrTextContent.children.length + parentElement->floatingChildrenCount;
     Clay_ElementId elementId = Clay__HashNumber(offset, parentElement->id);
     openLayoutElement->id = elementId.id;
-    Clay__AddHashMapItem(elementId, openLayoutElement);
+    Clay_LayoutElementHashMapItem *hashMapItem = Clay__AddHashMapItem(elementId, openLayoutElement);
+    if (context->incrementalLayoutEnabled) {
+        Clay__StoreLayoutElementHashMapItemIndex(openLayoutElement, hashMapItem);
+    }
     Clay__StringArray_Add(&context->layoutElementIdStrings, elementId.stringId);
     return elementId;
 }
@@ -1794,7 +2222,8 @@ bool Clay__ElementHasConfig(Clay_LayoutElement *layoutElement, Clay__ElementConf
     return false;
 }
 
-void Clay__UpdateAspectRatioBox(Clay_LayoutElement *layoutElement) {
+// Derives a missing width or height from the other one, width and height are either the element's dimensions or its staged sizes
+void Clay__UpdateAspectRatioBox(Clay_LayoutElement *layoutElement, float *width, float *height) {
     for (int32_t j = 0; j < layoutElement->elementConfigs.length; j++) {
         Clay_ElementConfig *config = Clay__ElementConfigArraySlice_Get(&layoutElement->elementConfigs, j);
         if (config->type == CLAY__ELEMENT_CONFIG_TYPE_ASPECT) {
@@ -1802,16 +2231,127 @@ void Clay__UpdateAspectRatioBox(Clay_LayoutElement *layoutElement) {
             if (aspectConfig->aspectRatio == 0) {
                 break;
             }
-            if (layoutElement->dimensions.width == 0 && layoutElement->dimensions.height != 0) {
-                layoutElement->dimensions.width = layoutElement->dimensions.height * aspectConfig->aspectRatio;
-            } else if (layoutElement->dimensions.width != 0 && layoutElement->dimensions.height == 0) {
-                layoutElement->dimensions.height = layoutElement->dimensions.width * (1 / aspectConfig->aspectRatio);
+            if (*width == 0 && *height != 0) {
+                *width = *height * aspectConfig->aspectRatio;
+            } else if (*width != 0 && *height == 0) {
+                *height = *width * (1 / aspectConfig->aspectRatio);
             }
             break;
         }
     }
 }
 
+// Copies what the sizing passes read out of a finished element and its configs, see Clay__SizingAxisStaging.
+// Called as each element closes, while the element and its configs are still in the cache.
+void Clay__StageLayoutElementSizing(int32_t layoutElementIndex) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay_LayoutElement *element = &context->layoutElements.internalArray[layoutElementIndex];
+    Clay_Sizing sizing = element->layoutConfig->sizing;
+    Clay__SizingAxisStaging *stagingX = &context->sizingStaging[0];
+    Clay__SizingAxisStaging *stagingY = &context->sizingStaging[1];
+    stagingX->sizes.internalArray[layoutElementIndex] = element->dimensions.width;
+    stagingY->sizes.internalArray[layoutElementIndex] = element->dimensions.height;
+    stagingX->minSizes.internalArray[layoutElementIndex] = element->minDimensions.width;
+    stagingY->minSizes.internalArray[layoutElementIndex] = element->minDimensions.height;
+    stagingX->maxSizes.internalArray[layoutElementIndex] = sizing.width.type == CLAY__SIZING_TYPE_PERCENT ? sizing.width.size.percent : sizing.width.size.minMax.max;
+    stagingY->maxSizes.internalArray[layoutElementIndex] = sizing.height.type == CLAY__SIZING_TYPE_PERCENT ? sizing.height.size.percent : sizing.height.size.minMax.max;
+    stagingX->sizingTypes.internalArray[layoutElementIndex] = sizing.width.type;
+    stagingY->sizingTypes.internalArray[layoutElementIndex] = sizing.height.type;
+
+    uint8_t flags = 0;
+    bool isText = false;
+    bool wrapsText = false;
+    for (int32_t j = 0; j < element->elementConfigs.length; ++j) {
+        Clay_ElementConfig *config = &element->elementConfigs.internalArray[j];
+        switch (config->type) {
+            case CLAY__ELEMENT_CONFIG_TYPE_TEXT: {
+                isText = true;
+                wrapsText = config->config.textElementConfig->wrapMode == CLAY_TEXT_WRAP_WORDS;
+                break;
+            }
+            case CLAY__ELEMENT_CONFIG_TYPE_CLIP: {
+                flags |= config->config.clipElementConfig->horizontal ? CLAY__SIZING_FLAG_CLIP_X : 0;
+                flags |= config->config.clipElementConfig->vertical ? CLAY__SIZING_FLAG_CLIP_Y : 0;
+                break;
+            }
+            case CLAY__ELEMENT_CONFIG_TYPE_ASPECT: {
+                flags |= CLAY__SIZING_FLAG_ASPECT;
+                break;
+            }
+            case CLAY__ELEMENT_CONFIG_TYPE_FLOATING: {
+                flags |= CLAY__SIZING_FLAG_FLOATING;
+                break;
+            }
+            default: break;
+        }
+    }
+    if (!isText && element->childrenOrTextContent.children.length > 0) {
+        flags |= CLAY__SIZING_FLAG_HAS_CHILDREN;
+    }
+    if (!isText || wrapsText) {
+        flags |= sizing.width.type != CLAY__SIZING_TYPE_PERCENT && sizing.width.type != CLAY__SIZING_TYPE_FIXED ? CLAY__SIZING_FLAG_RESIZABLE_X : 0;
+        flags |= sizing.height.type != CLAY__SIZING_TYPE_PERCENT && sizing.height.type != CLAY__SIZING_TYPE_FIXED ? CLAY__SIZING_FLAG_RESIZABLE_Y : 0;
+    }
+    context->layoutElementSizingFlags.internalArray[layoutElementIndex] = flags;
+}
+
+uint32_t Clay__HashLayoutValue(uint32_t hash, uint32_t value) {
+    hash += value;
+    hash += (hash << 10);
+    hash ^= (hash >> 6);
+    return hash;
+}
+
+uint32_t Clay__HashLayoutFloat(uint32_t hash, float value) {
+    union { float asFloat; uint32_t asBits; } bits = { .asFloat = value };
+    return Clay__HashLayoutValue(hash, bits.asBits);
+}
+
+uint32_t Clay__HashLayoutFinalize(uint32_t hash) {
+    hash += (hash << 3);
+    hash ^= (hash >> 11);
+    hash += (hash << 15);
+    return hash + 1; // Reserve the hash result of zero as "can't be cached"
+}
+
+uint32_t Clay__HashLayoutSizingAxis(uint32_t hash, Clay_SizingAxis sizing) {
+    hash = Clay__HashLayoutValue(hash, sizing.type);
+    if (sizing.type == CLAY__SIZING_TYPE_PERCENT) {
+        return Clay__HashLayoutFloat(hash, sizing.size.percent);
+    }
+    hash = Clay__HashLayoutFloat(hash, sizing.size.minMax.min);
+    return Clay__HashLayoutFloat(hash, sizing.size.minMax.max);
+}
+
+// Hashes everything that can influence the sizes inside this element's subtree, given the size the element itself ends up with.
+// Children have already been closed, so their hashes are available. Returns 0 if the subtree can't be reused across frames.
+uint32_t Clay__HashLayoutElement(Clay_LayoutElement *layoutElement) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay_LayoutConfig *layoutConfig = layoutElement->layoutConfig;
+    uint32_t hash = Clay__HashLayoutSizingAxis(0, layoutConfig->sizing.width);
+    hash = Clay__HashLayoutSizingAxis(hash, layoutConfig->sizing.height);
+    hash = Clay__HashLayoutValue(hash, layoutConfig->padding.left | ((uint32_t)layoutConfig->padding.right << 16));
+    hash = Clay__HashLayoutValue(hash, layoutConfig->padding.top | ((uint32_t)layoutConfig->padding.bottom << 16));
+    hash = Clay__HashLayoutValue(hash, layoutConfig->childGap | ((uint32_t)layoutConfig->layoutDirection << 16));
+    for (int32_t i = 0; i < layoutElement->elementConfigs.length; i++) {
+        Clay_ElementConfig *config = Clay__ElementConfigArraySlice_Get(&layoutElement->elementConfigs, i);
+        if (config->type == CLAY__ELEMENT_CONFIG_TYPE_CLIP) {
+            hash = Clay__HashLayoutValue(hash, CLAY__ELEMENT_CONFIG_TYPE_CLIP | (config->config.clipElementConfig->horizontal << 8) | (config->config.clipElementConfig->vertical << 9));
+        } else if (config->type == CLAY__ELEMENT_CONFIG_TYPE_ASPECT) {
+            // Aspect ratio elements are resized again after each sizing pass, so their cached dimensions don't describe a single pass
+            return 0;
+        }
+    }
+    for (int32_t i = 0; i < layoutElement->childrenOrTextContent.children.length; i++) {
+        uint32_t childHash = context->layoutElementLayoutHashes.internalArray[layoutElement->childrenOrTextContent.children.elements[i]];
+        if (childHash == 0) {
+            return 0;
+        }
+        hash = Clay__HashLayoutValue(hash, childHash);
+    }
+    return Clay__HashLayoutFinalize(hash);
+}
+
 void Clay__CloseElement(void) {
     Clay_Context* context = Clay_GetCurrentContext();
     if (context->booleanWarnings.maxElementsExceeded) {
@@ -1913,7 +2453,14 @@ void Clay__CloseElement(void) {
         openLayoutElement->dimensions.height = 0;
     }
 
-    Clay__UpdateAspectRatioBox(openLayoutElement);
+    if (context->incrementalLayoutEnabled) {
+        Clay__uint32_tArray_Set(&context->layoutElementLayoutHashes, (int32_t)(openLayoutElement - context->layoutElements.internalArray), Clay__HashLayoutElement(openLayoutElement));
+    }
+
+    Clay__UpdateAspectRatioBox(openLayoutElement, &openLayoutElement->dimensions.width, &openLayoutElement->dimensions.height);
+    int32_t openLayoutElementIndex = (int32_t)(openLayoutElement - context->layoutElements.internalArray);
+    Clay__StageLayoutElementSizing(openLayoutElementIndex);
+    Clay__int32_tArray_Set(&context->layoutElementSubtreeSizes, openLayoutElementIndex, context->layoutElements.length - openLayoutElementIndex);
 
     bool elementIsFloating = Clay__ElementHasConfig(openLayoutElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING);
 
@@ -2025,7 +2572,10 @@ void Clay__OpenElementWithId(Clay_ElementId elementId) {
     layoutElement.id = elementId.id;
     Clay_LayoutElement * openLayoutElement = Clay_LayoutElementArray_Add(&context->layoutElements, layoutElement);
     Clay__int32_tArray_Add(&context->openLayoutElementStack, context->layoutElements.length - 1);
-    Clay__AddHashMapItem(elementId, openLayoutElement);
+    Clay_LayoutElementHashMapItem *hashMapItem = Clay__AddHashMapItem(elementId, openLayoutElement);
+    if (context->incrementalLayoutEnabled) {
+        Clay__StoreLayoutElementHashMapItemIndex(openLayoutElement, hashMapItem);
+    }
     Clay__StringArray_Add(&context->layoutElementIdStrings, elementId.stringId);
     if (context->openClipElementStack.length > 0) {
         Clay__int32_tArray_Set(&context->layoutElementClipElementIds, context->layoutElements.length - 1, Clay__int32_tArray_GetValue(&context->openClipElementStack, (int)context->openClipElementStack.length - 1));
@@ -2054,7 +2604,18 @@ void Clay__OpenTextElement(Clay_String text, Clay_TextElementConfig *textConfig)
     Clay__MeasureTextCacheItem *textMeasured = Clay__MeasureTextCached(&text, textConfig);
     Clay_ElementId elementId = Clay__HashNumber(parentElement->childrenOrTextContent.children.length + parentElement->floatingChildrenCount, parentElement->id);
     textElement->id = elementId.id;
-    Clay__AddHashMapItem(elementId, textElement);
+    Clay_LayoutElementHashMapItem *hashMapItem = Clay__AddHashMapItem(elementId, textElement);
+    if (context->incrementalLayoutEnabled) {
+        Clay__StoreLayoutElementHashMapItemIndex(textElement, hashMapItem);
+        // The measurement cache id already covers the string and the config values that affect measurement
+        uint32_t textHash = 0;
+        if (textMeasured->id != 0) {
+            textHash = Clay__HashLayoutValue(textMeasured->id, textConfig->lineHeight);
+            textHash = Clay__HashLayoutValue(textHash, textConfig->wrapMode);
+            textHash = Clay__HashLayoutFinalize(textHash);
+        }
+        Clay__uint32_tArray_Set(&context->layoutElementLayoutHashes, context->layoutElements.length - 1, textHash);
+    }
     Clay__StringArray_Add(&context->layoutElementIdStrings, elementId.stringId);
     Clay_Dimensions textDimensions = { .width = textMeasured->unwrappedDimensions.width, .height = textConfig->lineHeight > 0 ? (float)textConfig->lineHeight : textMeasured->unwrappedDimensions.height };
     textElement->dimensions = textDimensions;
@@ -2065,6 +2626,8 @@ void Clay__OpenTextElement(Clay_String text, Clay_TextElementConfig *textConfig)
             .internalArray = Clay__ElementConfigArray_Add(&context->elementConfigs, CLAY__INIT(Clay_ElementConfig) { .type = CLAY__ELEMENT_CONFIG_TYPE_TEXT, .config = { .textElementConfig = textConfig }})
     };
     textElement->layoutConfig = &CLAY_LAYOUT_DEFAULT;
+    Clay__StageLayoutElementSizing(context->layoutElements.length - 1);
+    Clay__int32_tArray_Set(&context->layoutElementSubtreeSizes, context->layoutElements.length - 1, 1);
     parentElement->childrenOrTextContent.children.length++;
 }
 
@@ -2206,6 +2769,7 @@ void Clay__InitializeEphemeralMemory(Clay_Context* context) {
     context->wrappedTextLines = Clay__WrappedTextLineArray_Allocate_Arena(maxElementCount, arena);
     context->layoutElementTreeNodeArray1 = Clay__LayoutElementTreeNodeArray_Allocate_Arena(maxElementCount, arena);
     context->layoutElementTreeRoots = Clay__LayoutElementTreeRootArray_Allocate_Arena(maxElementCount, arena);
+    context->layoutElementTreeRootsSortBuffer = Clay__LayoutElementTreeRootArray_Allocate_Arena(maxElementCount, arena);
     context->layoutElementChildren = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
     context->openLayoutElementStack = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
     context->textElementData = Clay__TextElementDataArray_Allocate_Arena(maxElementCount, arena);
@@ -2216,7 +2780,29 @@ void Clay__InitializeEphemeralMemory(Clay_Context* context) {
     context->openClipElementStack = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
     context->reusableElementIndexBuffer = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
     context->layoutElementClipElementIds = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
+    context->layoutElementHashMapItemIndexes = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
+    context->layoutElementLayoutHashes = Clay__uint32_tArray_Allocate_Arena(maxElementCount, arena);
     context->dynamicStringData = Clay__charArray_Allocate_Arena(maxElementCount, arena);
+    context->renderCommandSnapshotLookup = Clay__int32_tArray_Allocate_Arena(maxElementCount * 2, arena);
+    context->renderCommandDiffs = Clay_RenderCommandDiffArray_Allocate_Arena(maxElementCount * 2, arena);
+    context->damageRects = Clay_BoundingBoxArray_Allocate_Arena(CLAY__MAX_DAMAGE_RECT_COUNT, arena);
+    context->pointerIndexEntries = Clay__PointerIndexEntryArray_Allocate_Arena(maxElementCount, arena);
+    context->pointerIndexNodes = Clay__PointerIndexNodeArray_Allocate_Arena(maxElementCount * 2, arena);
+    context->pointerIndexOrder = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
+    context->pointerIndexStack = Clay__int32_tArray_Allocate_Arena(maxElementCount * 2, arena);
+    context->pointerIndexHits = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
+    context->layoutElementTreeSizes = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
+    context->layoutElementRootIndexes = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
+    context->sizingTasks = Clay__SizingTaskArray_Allocate_Arena(maxElementCount, arena);
+    for (int32_t axis = 0; axis < 2; ++axis) {
+        context->sizingStaging[axis].sizes = Clay__floatArray_Allocate_Arena(maxElementCount, arena);
+        context->sizingStaging[axis].minSizes = Clay__floatArray_Allocate_Arena(maxElementCount, arena);
+        context->sizingStaging[axis].maxSizes = Clay__floatArray_Allocate_Arena(maxElementCount, arena);
+        context->sizingStaging[axis].sizingTypes = Clay__SizingTypeArray_Allocate_Arena(maxElementCount, arena);
+    }
+    context->layoutElementSizingFlags = Clay__uint8_tArray_Allocate_Arena(maxElementCount, arena);
+    context->layoutElementSubtreeSizes = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
+    context->resizableLimitBuffer = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
 }
 
 void Clay__InitializePersistentMemory(Clay_Context* context) {
@@ -2227,17 +2813,152 @@ void Clay__InitializePersistentMemory(Clay_Context* context) {
 
     context->scrollContainerDatas = Clay__ScrollContainerDataInternalArray_Allocate_Arena(100, arena);
     context->layoutElementsHashMapInternal = Clay__LayoutElementHashMapItemArray_Allocate_Arena(maxElementCount, arena);
-    context->layoutElementsHashMap = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
+    context->layoutElementsHashMapCold = Clay__LayoutElementHashMapItemColdArray_Allocate_Arena(maxElementCount, arena);
+    // A power of two with at least twice the slots of items, so slots are found by masking and probe sequences stay short
+    int32_t hashMapSlotCount = 1;
+    while (hashMapSlotCount < maxElementCount * 2) {
+        hashMapSlotCount *= 2;
+    }
+    context->layoutElementsHashMap = Clay__LayoutElementHashMapSlotArray_Allocate_Arena(hashMapSlotCount, arena);
     context->measureTextHashMapInternal = Clay__MeasureTextCacheItemArray_Allocate_Arena(maxElementCount, arena);
     context->measureTextHashMapInternalFreeList = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
     context->measuredWordsFreeList = Clay__int32_tArray_Allocate_Arena(maxMeasureTextCacheWordCount, arena);
-    context->measureTextHashMap = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
+    // Text measurements are bucketed by word capacity, which can outgrow the element count
+    context->measureTextHashMap = Clay__int32_tArray_Allocate_Arena(CLAY__MAX(maxElementCount, maxMeasureTextCacheWordCount / 32), arena);
     context->measuredWords = Clay__MeasuredWordArray_Allocate_Arena(maxMeasureTextCacheWordCount, arena);
     context->pointerOverIds = Clay_ElementIdArray_Allocate_Arena(maxElementCount, arena);
-    context->debugElementData = Clay__DebugElementDataArray_Allocate_Arena(maxElementCount, arena);
+    context->renderCommandSnapshots = Clay__RenderCommandSnapshotArray_Allocate_Arena(maxElementCount, arena);
+    context->previousRenderCommandSnapshots = Clay__RenderCommandSnapshotArray_Allocate_Arena(maxElementCount, arena);
+    context->cachedWrappedTextLines = Clay__CachedWrappedTextLineArray_Allocate_Arena(maxElementCount, arena);
+    context->cachedWrappedTextLineCounts = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
     context->arenaResetOffset = arena->nextAllocation;
 }
 
+// Bytes needed for every internal array at the given capacities, not counting the context itself
+size_t Clay__ArraysMemorySize(int32_t maxElementCount, int32_t maxMeasureTextCacheWordCount) {
+    Clay_Context fakeContext = {
+        .maxElementCount = maxElementCount,
+        .maxMeasureTextCacheWordCount = maxMeasureTextCacheWordCount,
+        .internalArena = {
+            .capacity = SIZE_MAX,
+            .memory = NULL,
+        }
+    };
+    Clay__InitializePersistentMemory(&fakeContext);
+    Clay__InitializeEphemeralMemory(&fakeContext);
+    return fakeContext.internalArena.nextAllocation + 128;
+}
+
+void Clay__CopyMemory(void *destination, const void *source, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        ((char *)destination)[i] = ((const char *)source)[i];
+    }
+}
+
+// Persistent items keep pointers into arrays that move, the index they point at is kept
+#define CLAY__RELOCATE_POINTER(pointer, oldArray, newArray) \
+    if ((pointer) >= (oldArray).internalArray && (pointer) < (oldArray).internalArray + (oldArray).capacity) (pointer) = (newArray).internalArray + ((pointer) - (oldArray).internalArray)
+
+#define CLAY__COPY_ARRAY(newArray, oldArray) \
+    Clay__CopyMemory((newArray).internalArray, (oldArray).internalArray, sizeof(*(oldArray).internalArray) * (size_t)(oldArray).length); \
+    (newArray).length = (oldArray).length
+
+// Moves every internal array into a single larger block from the grow functions, keeping all persistent state.
+// Only called between frames, so nothing from the ephemeral arrays needs to survive.
+bool Clay__GrowContext(int32_t maxElementCount, int32_t maxMeasureTextCacheWordCount) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    size_t size = Clay__ArraysMemorySize(maxElementCount, maxMeasureTextCacheWordCount);
+    void *memory = context->growAllocateFunction(size, context->growUserData);
+    if (!memory) {
+        return false;
+    }
+    Clay_Context old = *context;
+    context->maxElementCount = maxElementCount;
+    context->maxMeasureTextCacheWordCount = maxMeasureTextCacheWordCount;
+    // Cacheline align memory passed in, like Clay_Initialize
+    uintptr_t baseOffset = 64 - ((uintptr_t)memory % 64);
+    baseOffset = baseOffset == 64 ? 0 : baseOffset;
+    context->internalArena = CLAY__INIT(Clay_Arena) { .capacity = size - baseOffset, .memory = (char *)memory + baseOffset };
+    Clay__InitializePersistentMemory(context);
+    Clay__InitializeEphemeralMemory(context);
+
+    CLAY__COPY_ARRAY(context->scrollContainerDatas, old.scrollContainerDatas);
+    for (int32_t i = 0; i < context->scrollContainerDatas.length; ++i) {
+        CLAY__RELOCATE_POINTER(context->scrollContainerDatas.internalArray[i].layoutElement, old.layoutElements, context->layoutElements);
+    }
+    CLAY__COPY_ARRAY(context->pointerOverIds, old.pointerOverIds);
+    for (int32_t i = 0; i < context->pointerOverIds.length; ++i) {
+        CLAY__RELOCATE_POINTER(context->pointerOverIds.internalArray[i].stringId.chars, old.dynamicStringData, context->dynamicStringData);
+    }
+    CLAY__COPY_ARRAY(context->renderCommandSnapshots, old.renderCommandSnapshots);
+    CLAY__COPY_ARRAY(context->previousRenderCommandSnapshots, old.previousRenderCommandSnapshots);
+    CLAY__COPY_ARRAY(context->cachedWrappedTextLines, old.cachedWrappedTextLines);
+    CLAY__COPY_ARRAY(context->cachedWrappedTextLineCounts, old.cachedWrappedTextLineCounts);
+
+    // Slots depend on the slot count, so every item is inserted again. Items keep their index.
+    CLAY__COPY_ARRAY(context->layoutElementsHashMapInternal, old.layoutElementsHashMapInternal);
+    CLAY__COPY_ARRAY(context->layoutElementsHashMapCold, old.layoutElementsHashMapCold);
+    for (int32_t i = 0; i < context->layoutElementsHashMap.capacity; ++i) {
+        context->layoutElementsHashMap.internalArray[i] = CLAY__INIT(Clay__LayoutElementHashMapSlot) CLAY__DEFAULT_STRUCT;
+    }
+    for (int32_t i = 0; i < context->layoutElementsHashMapInternal.length; ++i) {
+        Clay_LayoutElementHashMapItem *item = &context->layoutElementsHashMapInternal.internalArray[i];
+        CLAY__RELOCATE_POINTER(item->layoutElement, old.layoutElements, context->layoutElements);
+        CLAY__RELOCATE_POINTER(context->layoutElementsHashMapCold.internalArray[i].elementId.stringId.chars, old.dynamicStringData, context->dynamicStringData);
+        Clay__InsertHashMapSlot(item->id, i);
+    }
+
+    // Text measurements keep their indexes, so the measured word lists, free lists and the LRU list stay valid
+    CLAY__COPY_ARRAY(context->measureTextHashMapInternal, old.measureTextHashMapInternal);
+    CLAY__COPY_ARRAY(context->measureTextHashMapInternalFreeList, old.measureTextHashMapInternalFreeList);
+    CLAY__COPY_ARRAY(context->measuredWords, old.measuredWords);
+    CLAY__COPY_ARRAY(context->measuredWordsFreeList, old.measuredWordsFreeList);
+    for (int32_t i = 0; i < context->measureTextHashMap.capacity; ++i) {
+        context->measureTextHashMap.internalArray[i] = 0;
+    }
+    // Buckets depend on the word capacity, only items reachable from the old buckets are live
+    uint32_t oldBucketCount = (uint32_t)(old.maxMeasureTextCacheWordCount / 32);
+    uint32_t bucketCount = (uint32_t)(context->maxMeasureTextCacheWordCount / 32);
+    for (uint32_t oldBucket = 0; oldBucket < oldBucketCount; ++oldBucket) {
+        int32_t itemIndex = old.measureTextHashMap.internalArray[oldBucket];
+        while (itemIndex != 0) {
+            Clay__MeasureTextCacheItem *item = &context->measureTextHashMapInternal.internalArray[itemIndex];
+            int32_t nextItemIndex = item->nextIndex;
+            uint32_t hashBucket = item->id % bucketCount;
+            item->nextIndex = context->measureTextHashMap.internalArray[hashBucket];
+            context->measureTextHashMap.internalArray[hashBucket] = itemIndex;
+            itemIndex = nextItemIndex;
+        }
+    }
+
+    if (old.grownMemory) {
+        context->growFreeFunction(old.grownMemory, context->growUserData);
+    }
+    context->grownMemory = memory;
+    return true;
+}
+
+// Doubles the capacities the previous frame overflowed or came close to, see Clay_SetGrowFunctions
+void Clay__GrowContextIfNeeded(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    int32_t elementsUsed = CLAY__MAX(context->layoutElements.length, context->elementConfigs.length);
+    elementsUsed = CLAY__MAX(elementsUsed, CLAY__MAX(context->renderCommands.length, context->wrappedTextLines.length));
+    elementsUsed = CLAY__MAX(elementsUsed, CLAY__MAX(context->layoutElementsHashMapInternal.length, context->dynamicStringData.length));
+    elementsUsed = CLAY__MAX(elementsUsed, context->measureTextHashMapInternal.length - context->measureTextHashMapInternalFreeList.length);
+    int32_t wordsUsed = context->measuredWords.length - context->measuredWordsFreeList.length;
+    int32_t maxElementCount = context->maxElementCount;
+    int32_t maxMeasureTextCacheWordCount = context->maxMeasureTextCacheWordCount;
+    if (context->booleanWarnings.maxElementsExceeded || elementsUsed > maxElementCount / 4 * 3) {
+        maxElementCount *= 2;
+    }
+    if (context->booleanWarnings.maxTextMeasureCacheExceeded || wordsUsed > maxMeasureTextCacheWordCount / 4 * 3) {
+        maxMeasureTextCacheWordCount *= 2;
+    }
+    if (maxElementCount != context->maxElementCount || maxMeasureTextCacheWordCount != context->maxMeasureTextCacheWordCount) {
+        Clay__GrowContext(maxElementCount, maxMeasureTextCacheWordCount);
+    }
+}
+
 const float CLAY__EPSILON = 0.01;
 
 bool Clay__FloatEqual(float left, float right) {
@@ -2245,228 +2966,709 @@ bool Clay__FloatEqual(float left, float right) {
     return subtracted < CLAY__EPSILON && subtracted > -CLAY__EPSILON;
 }
 
-void Clay__SizeContainersAlongAxis(bool xAxis) {
+// Stable bottom up merge sort, roots sharing a z-index stay in declaration order
+void Clay__SortLayoutElementTreeRoots(void) {
     Clay_Context* context = Clay_GetCurrentContext();
-    Clay__int32_tArray bfsBuffer = context->layoutElementChildrenBuffer;
-    Clay__int32_tArray resizableContainerBuffer = context->openLayoutElementStack;
-    for (int32_t rootIndex = 0; rootIndex < context->layoutElementTreeRoots.length; ++rootIndex) {
-        bfsBuffer.length = 0;
-        Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, rootIndex);
-        Clay_LayoutElement *rootElement = Clay_LayoutElementArray_Get(&context->layoutElements, (int)root->layoutElementIndex);
-        Clay__int32_tArray_Add(&bfsBuffer, (int32_t)root->layoutElementIndex);
-
-        // Size floating containers to their parents
-        if (Clay__ElementHasConfig(rootElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING)) {
-            Clay_FloatingElementConfig *floatingElementConfig = Clay__FindElementConfigWithType(rootElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING).floatingElementConfig;
-            Clay_LayoutElementHashMapItem *parentItem = Clay__GetHashMapItem(floatingElementConfig->parentId);
-            if (parentItem && parentItem != &Clay_LayoutElementHashMapItem_DEFAULT) {
-                Clay_LayoutElement *parentLayoutElement = parentItem->layoutElement;
-                switch (rootElement->layoutConfig->sizing.width.type) {
-                    case CLAY__SIZING_TYPE_GROW: {
-                        rootElement->dimensions.width = parentLayoutElement->dimensions.width;
-                        break;
-                    }
-                    case CLAY__SIZING_TYPE_PERCENT: {
-                        rootElement->dimensions.width = parentLayoutElement->dimensions.width * rootElement->layoutConfig->sizing.width.size.percent;
-                        break;
-                    }
-                    default: break;
+    int32_t length = context->layoutElementTreeRoots.length;
+    Clay__LayoutElementTreeRoot *source = context->layoutElementTreeRoots.internalArray;
+    Clay__LayoutElementTreeRoot *destination = context->layoutElementTreeRootsSortBuffer.internalArray;
+    bool sorted = true;
+    for (int32_t i = 1; i < length; ++i) {
+        if (source[i].zIndex < source[i - 1].zIndex) {
+            sorted = false;
+            break;
+        }
+    }
+    if (sorted) {
+        return;
+    }
+    for (int32_t width = 1; width < length; width *= 2) {
+        for (int32_t start = 0; start < length; start += width * 2) {
+            int32_t middle = CLAY__MIN(start + width, length);
+            int32_t end = CLAY__MIN(start + width * 2, length);
+            int32_t left = start;
+            int32_t right = middle;
+            int32_t output = start;
+            while (left < middle && right < end) {
+                destination[output++] = source[right].zIndex < source[left].zIndex ? source[right++] : source[left++];
+            }
+            while (left < middle) {
+                destination[output++] = source[left++];
+            }
+            while (right < end) {
+                destination[output++] = source[right++];
+            }
+        }
+        Clay__LayoutElementTreeRoot *swap = source;
+        source = destination;
+        destination = swap;
+    }
+    if (source != context->layoutElementTreeRoots.internalArray) {
+        for (int32_t i = 0; i < length; ++i) {
+            context->layoutElementTreeRoots.internalArray[i] = source[i];
+        }
+    }
+}
+
+bool Clay__IncrementalLayoutActive(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    // Hashes are only trustworthy if every element was opened and closed normally this frame
+    return context->incrementalLayoutEnabled && !context->booleanWarnings.maxElementsExceeded && context->openLayoutElementStack.length <= 1;
+}
+
+// Returns the hash map item holding last frame's results for this element, or NULL if its subtree has changed or was never cached
+Clay_LayoutElementHashMapItem *Clay__GetIncrementalLayoutItem(int32_t layoutElementIndex) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    uint32_t layoutHash = context->layoutElementLayoutHashes.internalArray[layoutElementIndex];
+    int32_t hashMapItemIndex = context->layoutElementHashMapItemIndexes.internalArray[layoutElementIndex];
+    if (layoutHash == 0 || hashMapItemIndex < 0) {
+        return NULL;
+    }
+    Clay_LayoutElementHashMapItem *hashMapItem = &context->layoutElementsHashMapInternal.internalArray[hashMapItemIndex];
+    return hashMapItem->layoutHash == layoutHash ? hashMapItem : NULL;
+}
+
+// If a parent's subtree is unchanged and it was given the same size as last frame, its children end up with exactly last frame's sizes.
+// The height pass also requires the same width, as text wrapping (and so every fit height below) depends on it.
+bool Clay__ReuseCachedChildSizes(int32_t parentIndex, bool xAxis, Clay__int32_tArray *bfsBuffer) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay_LayoutElement *parent = Clay_LayoutElementArray_Get(&context->layoutElements, parentIndex);
+    float *sizes = context->sizingStaging[xAxis ? 0 : 1].sizes.internalArray;
+    Clay_LayoutElementHashMapItem *parentItem = Clay__GetIncrementalLayoutItem(parentIndex);
+    if (!parentItem || context->sizingStaging[0].sizes.internalArray[parentIndex] != parentItem->layoutDimensions.width || (!xAxis && sizes[parentIndex] != parentItem->layoutDimensions.height)) {
+        return false;
+    }
+    // Check every child before writing to any of them, so a miss can fall back to the regular pass with untouched inputs
+    for (int32_t childOffset = 0; childOffset < parent->childrenOrTextContent.children.length; childOffset++) {
+        if (!Clay__GetIncrementalLayoutItem(parent->childrenOrTextContent.children.elements[childOffset])) {
+            return false;
+        }
+    }
+    for (int32_t childOffset = 0; childOffset < parent->childrenOrTextContent.children.length; childOffset++) {
+        int32_t childElementIndex = parent->childrenOrTextContent.children.elements[childOffset];
+        Clay_Dimensions cachedDimensions = Clay__GetIncrementalLayoutItem(childElementIndex)->layoutDimensions;
+        sizes[childElementIndex] = xAxis ? cachedDimensions.width : cachedDimensions.height;
+        if (bfsBuffer && (context->layoutElementSizingFlags.internalArray[childElementIndex] & CLAY__SIZING_FLAG_HAS_CHILDREN)) {
+            Clay__int32_tArray_Add(bfsBuffer, childElementIndex);
+        }
+    }
+    return true;
+}
+
+// Combines the hashes of every tree root with what its size depends on outside of its subtree.
+// Returns 0 if any root can't be reused across frames.
+uint32_t Clay__HashLayoutTreeRoots(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    uint32_t hash = Clay__HashLayoutValue(0, (uint32_t)context->textElementData.length);
+    for (int32_t i = 0; i < context->layoutElementTreeRoots.length; ++i) {
+        Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, i);
+        uint32_t rootHash = context->layoutElementLayoutHashes.internalArray[root->layoutElementIndex];
+        if (rootHash == 0) {
+            return 0;
+        }
+        hash = Clay__HashLayoutValue(hash, rootHash);
+        // Floating roots are sized from the element they are attached to
+        hash = Clay__HashLayoutValue(hash, root->parentId);
+    }
+    return Clay__HashLayoutFinalize(hash);
+}
+
+// Saves this frame's hashes, final dimensions and wrapped text lines for the next frame's Clay__ReuseCachedChildSizes and Clay__ReuseLastLayoutSizes
+void Clay__StoreIncrementalLayoutResults(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    for (int32_t i = 0; i < context->layoutElements.length; ++i) {
+        int32_t hashMapItemIndex = context->layoutElementHashMapItemIndexes.internalArray[i];
+        if (hashMapItemIndex < 0) {
+            continue;
+        }
+        Clay_LayoutElementHashMapItem *hashMapItem = &context->layoutElementsHashMapInternal.internalArray[hashMapItemIndex];
+        hashMapItem->layoutHash = context->layoutElementLayoutHashes.internalArray[i];
+        hashMapItem->layoutDimensions = context->layoutElements.internalArray[i].dimensions;
+    }
+    context->cachedWrappedTextLines.length = 0;
+    context->cachedWrappedTextLineCounts.length = 0;
+    for (int32_t i = 0; i < context->textElementData.length; ++i) {
+        Clay__TextElementData *textElementData = Clay__TextElementDataArray_Get(&context->textElementData, i);
+        Clay__int32_tArray_Add(&context->cachedWrappedTextLineCounts, textElementData->wrappedLines.length);
+        for (int32_t lineIndex = 0; lineIndex < textElementData->wrappedLines.length; ++lineIndex) {
+            Clay__WrappedTextLine *wrappedLine = Clay__WrappedTextLineArraySlice_Get(&textElementData->wrappedLines, lineIndex);
+            Clay__CachedWrappedTextLineArray_Add(&context->cachedWrappedTextLines, CLAY__INIT(Clay__CachedWrappedTextLine) {
+                .dimensions = wrappedLine->dimensions,
+                .startOffset = (int32_t)(wrappedLine->line.chars - textElementData->text.chars),
+                .length = wrappedLine->line.length,
+            });
+        }
+    }
+    context->cachedLayoutTreeHash = Clay__HashLayoutTreeRoots();
+}
+
+// When nothing the sizing passes depend on has changed since the last full layout, which is the case while only scroll offsets move,
+// every element gets its last final size and text its last wrapped lines back, and only positions and render commands are calculated again.
+// Returns false without changing anything otherwise.
+bool Clay__ReuseLastLayoutSizes(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    uint32_t treeHash = Clay__HashLayoutTreeRoots();
+    if (treeHash == 0 || treeHash != context->cachedLayoutTreeHash || context->textElementData.length != context->cachedWrappedTextLineCounts.length) {
+        return false;
+    }
+    // Element ids are not part of the hashes, so every element still has to find its own results
+    for (int32_t i = 0; i < context->layoutElements.length; ++i) {
+        if (!Clay__GetIncrementalLayoutItem(i)) {
+            return false;
+        }
+    }
+    for (int32_t i = 0; i < context->layoutElements.length; ++i) {
+        context->layoutElements.internalArray[i].dimensions = Clay__GetIncrementalLayoutItem(i)->layoutDimensions;
+    }
+    int32_t cachedLineIndex = 0;
+    for (int32_t i = 0; i < context->textElementData.length; ++i) {
+        Clay__TextElementData *textElementData = Clay__TextElementDataArray_Get(&context->textElementData, i);
+        textElementData->wrappedLines = CLAY__INIT(Clay__WrappedTextLineArraySlice) { .length = 0, .internalArray = &context->wrappedTextLines.internalArray[context->wrappedTextLines.length] };
+        int32_t lineCount = context->cachedWrappedTextLineCounts.internalArray[i];
+        for (int32_t lineIndex = 0; lineIndex < lineCount; ++lineIndex) {
+            Clay__CachedWrappedTextLine *cachedLine = &context->cachedWrappedTextLines.internalArray[cachedLineIndex++];
+            Clay__WrappedTextLineArray_Add(&context->wrappedTextLines, CLAY__INIT(Clay__WrappedTextLine) { cachedLine->dimensions, { .length = cachedLine->length, .chars = &textElementData->text.chars[cachedLine->startOffset] } });
+            textElementData->wrappedLines.length++;
+        }
+    }
+    return true;
+}
+
+// Writes the staged sizes back to the elements once both axes are sized
+void Clay__StoreStagedSizes(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    float *widths = context->sizingStaging[0].sizes.internalArray;
+    float *heights = context->sizingStaging[1].sizes.internalArray;
+    Clay_LayoutElement *elements = context->layoutElements.internalArray;
+    for (int32_t i = 0; i < context->layoutElements.length; ++i) {
+        elements[i].dimensions.width = widths[i];
+        elements[i].dimensions.height = heights[i];
+    }
+}
+
+// Sizes a root element before its children, floating roots take their size from the element they are attached to
+void Clay__SizeRootElement(Clay__LayoutElementTreeRoot *root) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    int32_t rootIndex = (int32_t)root->layoutElementIndex;
+    Clay_LayoutElement *rootElement = Clay_LayoutElementArray_Get(&context->layoutElements, rootIndex);
+    float *widths = context->sizingStaging[0].sizes.internalArray;
+    float *heights = context->sizingStaging[1].sizes.internalArray;
+    float *rootWidth = &widths[rootIndex];
+    float *rootHeight = &heights[rootIndex];
+    // Size floating containers to their parents
+    if (Clay__ElementHasConfig(rootElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING)) {
+        Clay_FloatingElementConfig *floatingElementConfig = Clay__FindElementConfigWithType(rootElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING).floatingElementConfig;
+        Clay_LayoutElementHashMapItem *parentItem = Clay__GetHashMapItem(floatingElementConfig->parentId);
+        if (parentItem && parentItem != &Clay_LayoutElementHashMapItem_DEFAULT) {
+            Clay_LayoutElement *parentLayoutElement = parentItem->layoutElement;
+            int32_t parentIndex = (int32_t)(parentLayoutElement - context->layoutElements.internalArray);
+            // Elements that weren't declared this frame were never staged
+            bool parentStaged = parentIndex >= 0 && parentIndex < context->layoutElements.length;
+            float parentWidth = parentStaged ? widths[parentIndex] : parentLayoutElement->dimensions.width;
+            float parentHeight = parentStaged ? heights[parentIndex] : parentLayoutElement->dimensions.height;
+            switch (rootElement->layoutConfig->sizing.width.type) {
+                case CLAY__SIZING_TYPE_GROW: {
+                    *rootWidth = parentWidth;
+                    break;
                 }
-                switch (rootElement->layoutConfig->sizing.height.type) {
-                    case CLAY__SIZING_TYPE_GROW: {
-                        rootElement->dimensions.height = parentLayoutElement->dimensions.height;
-                        break;
-                    }
-                    case CLAY__SIZING_TYPE_PERCENT: {
-                        rootElement->dimensions.height = parentLayoutElement->dimensions.height * rootElement->layoutConfig->sizing.height.size.percent;
-                        break;
-                    }
-                    default: break;
+                case CLAY__SIZING_TYPE_PERCENT: {
+                    *rootWidth = parentWidth * rootElement->layoutConfig->sizing.width.size.percent;
+                    break;
+                }
+                default: break;
+            }
+            switch (rootElement->layoutConfig->sizing.height.type) {
+                case CLAY__SIZING_TYPE_GROW: {
+                    *rootHeight = parentHeight;
+                    break;
                 }
+                case CLAY__SIZING_TYPE_PERCENT: {
+                    *rootHeight = parentHeight * rootElement->layoutConfig->sizing.height.size.percent;
+                    break;
+                }
+                default: break;
             }
         }
+    }
 
-        if (rootElement->layoutConfig->sizing.width.type != CLAY__SIZING_TYPE_PERCENT) {
-            rootElement->dimensions.width = CLAY__MIN(CLAY__MAX(rootElement->dimensions.width, rootElement->layoutConfig->sizing.width.size.minMax.min), rootElement->layoutConfig->sizing.width.size.minMax.max);
+    if (rootElement->layoutConfig->sizing.width.type != CLAY__SIZING_TYPE_PERCENT) {
+        *rootWidth = CLAY__MIN(CLAY__MAX(*rootWidth, rootElement->layoutConfig->sizing.width.size.minMax.min), rootElement->layoutConfig->sizing.width.size.minMax.max);
+    }
+    if (rootElement->layoutConfig->sizing.height.type != CLAY__SIZING_TYPE_PERCENT) {
+        *rootHeight = CLAY__MIN(CLAY__MAX(*rootHeight, rootElement->layoutConfig->sizing.height.size.minMax.min), rootElement->layoutConfig->sizing.height.size.minMax.max);
+    }
+}
+
+// Heap sort of indexes by values[index] * direction, ascending. Only the fallback of Clay__IntroSortIndexesByValue, which is faster on most inputs.
+void Clay__HeapSortIndexesByValue(int32_t *indexes, int32_t length, const float *values, float direction) {
+    for (int32_t heapLength = length, i = length / 2 - 1; heapLength > 1; ) {
+        int32_t root;
+        if (i >= 0) {
+            // Building the heap
+            root = i--;
+        } else {
+            // Moving the largest value behind the heap
+            int32_t largest = indexes[0];
+            indexes[0] = indexes[--heapLength];
+            indexes[heapLength] = largest;
+            root = 0;
         }
-        if (rootElement->layoutConfig->sizing.height.type != CLAY__SIZING_TYPE_PERCENT) {
-            rootElement->dimensions.height = CLAY__MIN(CLAY__MAX(rootElement->dimensions.height, rootElement->layoutConfig->sizing.height.size.minMax.min), rootElement->layoutConfig->sizing.height.size.minMax.max);
+        int32_t rootIndex = indexes[root];
+        float rootValue = values[rootIndex] * direction;
+        while (root * 2 + 1 < heapLength) {
+            int32_t child = root * 2 + 1;
+            if (child + 1 < heapLength && values[indexes[child + 1]] * direction > values[indexes[child]] * direction) {
+                child++;
+            }
+            if (values[indexes[child]] * direction <= rootValue) {
+                break;
+            }
+            indexes[root] = indexes[child];
+            root = child;
         }
+        indexes[root] = rootIndex;
+    }
+}
 
-        for (int32_t i = 0; i < bfsBuffer.length; ++i) {
-            int32_t parentIndex = Clay__int32_tArray_GetValue(&bfsBuffer, i);
-            Clay_LayoutElement *parent = Clay_LayoutElementArray_Get(&context->layoutElements, parentIndex);
-            Clay_LayoutConfig *parentStyleConfig = parent->layoutConfig;
-            int32_t growContainerCount = 0;
-            float parentSize = xAxis ? parent->dimensions.width : parent->dimensions.height;
-            float parentPadding = (float)(xAxis ? (parent->layoutConfig->padding.left + parent->layoutConfig->padding.right) : (parent->layoutConfig->padding.top + parent->layoutConfig->padding.bottom));
-            float innerContentSize = 0, totalPaddingAndChildGaps = parentPadding;
-            bool sizingAlongAxis = (xAxis && parentStyleConfig->layoutDirection == CLAY_LEFT_TO_RIGHT) || (!xAxis && parentStyleConfig->layoutDirection == CLAY_TOP_TO_BOTTOM);
-            resizableContainerBuffer.length = 0;
-            float parentChildGap = parentStyleConfig->childGap;
+// Quicksort recursing into the smaller side only, so the stack stays O(log n) deep. Once depthLimit partitions didn't shrink the range enough
+// it switches to heap sort, which keeps the worst case at O(n log n).
+void Clay__IntroSortIndexesByValue(int32_t *indexes, int32_t length, const float *values, float direction, int32_t depthLimit) {
+    while (length > 16) {
+        if (depthLimit-- == 0) {
+            Clay__HeapSortIndexesByValue(indexes, length, values, direction);
+            return;
+        }
+        // Median of the first, middle and last values as the pivot, they end up sorted among themselves
+        int32_t middle = (length - 1) / 2;
+        if (values[indexes[middle]] * direction < values[indexes[0]] * direction) {
+            int32_t swap = indexes[0];
+            indexes[0] = indexes[middle];
+            indexes[middle] = swap;
+        }
+        if (values[indexes[length - 1]] * direction < values[indexes[middle]] * direction) {
+            int32_t swap = indexes[middle];
+            indexes[middle] = indexes[length - 1];
+            indexes[length - 1] = swap;
+            if (values[indexes[middle]] * direction < values[indexes[0]] * direction) {
+                swap = indexes[0];
+                indexes[0] = indexes[middle];
+                indexes[middle] = swap;
+            }
+        }
+        // Hoare partition, values equal to the pivot are split between both sides so runs of equal sizes don't degrade it
+        float pivot = values[indexes[middle]] * direction;
+        int32_t left = -1;
+        int32_t right = length;
+        while (true) {
+            do { left++; } while (values[indexes[left]] * direction < pivot);
+            do { right--; } while (values[indexes[right]] * direction > pivot);
+            if (left >= right) {
+                break;
+            }
+            int32_t swap = indexes[left];
+            indexes[left] = indexes[right];
+            indexes[right] = swap;
+        }
+        int32_t lowerLength = right + 1;
+        if (lowerLength < length - lowerLength) {
+            Clay__IntroSortIndexesByValue(indexes, lowerLength, values, direction, depthLimit);
+            indexes += lowerLength;
+            length -= lowerLength;
+        } else {
+            Clay__IntroSortIndexesByValue(indexes + lowerLength, length - lowerLength, values, direction, depthLimit);
+            length = lowerLength;
+        }
+    }
+    // Insertion sort for the short ranges left
+    for (int32_t i = 1; i < length; ++i) {
+        int32_t index = indexes[i];
+        float value = values[index] * direction;
+        int32_t j = i;
+        for (; j > 0 && values[indexes[j - 1]] * direction > value; --j) {
+            indexes[j] = indexes[j - 1];
+        }
+        indexes[j] = index;
+    }
+}
 
-            for (int32_t childOffset = 0; childOffset < parent->childrenOrTextContent.children.length; childOffset++) {
-                int32_t childElementIndex = parent->childrenOrTextContent.children.elements[childOffset];
-                Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, childElementIndex);
-                Clay_SizingAxis childSizing = xAxis ? childElement->layoutConfig->sizing.width : childElement->layoutConfig->sizing.height;
-                float childSize = xAxis ? childElement->dimensions.width : childElement->dimensions.height;
+// Sorts indexes by values[index] * direction, ascending. Returns early when they already are, as with children that were all sized alike.
+void Clay__SortIndexesByValue(int32_t *indexes, int32_t length, const float *values, float direction) {
+    bool sorted = true;
+    for (int32_t i = 1; i < length; ++i) {
+        if (values[indexes[i]] * direction < values[indexes[i - 1]] * direction) {
+            sorted = false;
+            break;
+        }
+    }
+    if (sorted) {
+        return;
+    }
+    int32_t depthLimit = 0;
+    for (int32_t remaining = length; remaining > 1; remaining /= 2) {
+        depthLimit += 2;
+    }
+    Clay__IntroSortIndexesByValue(indexes, length, values, direction, depthLimit);
+}
 
-                if (!Clay__ElementHasConfig(childElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT) && childElement->childrenOrTextContent.children.length > 0) {
-                    Clay__int32_tArray_Add(&bfsBuffer, childElementIndex);
-                }
+// Water filling: raises the smallest children together to a common level until sizeToDistribute is used up, children stop rising at their limit.
+// Shrinking runs the same fill on negated sizes and limits, with direction -1: the largest children are lowered together, down to their limit.
+// Sorts childBuffer by size and fills limitBuffer with the children sorted by limit, then finds the level in one sweep over both.
+void Clay__DistributeSizeToChildren(float *sizes, const float *limits, Clay__int32_tArray childBuffer, Clay__int32_tArray limitBuffer, float sizeToDistribute, float direction) {
+    // Children already at their limit take no part
+    for (int32_t childIndex = 0; childIndex < childBuffer.length; childIndex++) {
+        int32_t childElementIndex = childBuffer.internalArray[childIndex];
+        if (limits[childElementIndex] * direction <= sizes[childElementIndex] * direction) {
+            Clay__int32_tArray_RemoveSwapback(&childBuffer, childIndex--);
+        }
+    }
+    if (childBuffer.length == 0) {
+        return;
+    }
+    Clay__SortIndexesByValue(childBuffer.internalArray, childBuffer.length, sizes, direction);
+    limitBuffer.length = 0;
+    for (int32_t childIndex = 0; childIndex < childBuffer.length; childIndex++) {
+        Clay__int32_tArray_Add(&limitBuffer, childBuffer.internalArray[childIndex]);
+    }
+    Clay__SortIndexesByValue(limitBuffer.internalArray, limitBuffer.length, limits, direction);
+
+    // Every child joins the fill when the level reaches its size, and leaves it when the level reaches its limit
+    float remaining = sizeToDistribute * direction;
+    float level = sizes[childBuffer.internalArray[0]] * direction;
+    int32_t nextJoin = 0, nextLeave = 0, activeCount = 0;
+    while (true) {
+        float joinLevel = nextJoin < childBuffer.length ? sizes[childBuffer.internalArray[nextJoin]] * direction : CLAY__MAXFLOAT;
+        float leaveLevel = limits[limitBuffer.internalArray[nextLeave]] * direction;
+        bool leaving = leaveLevel <= joinLevel;
+        float nextLevel = leaving ? leaveLevel : joinLevel;
+        if (activeCount > 0) {
+            float fill = (nextLevel - level) * (float)activeCount;
+            if (fill >= remaining) {
+                level += remaining / (float)activeCount;
+                break;
+            }
+            remaining -= fill;
+        }
+        level = nextLevel;
+        if (leaving) {
+            activeCount--;
+            if (++nextLeave == limitBuffer.length) {
+                // Every child reached its limit
+                break;
+            }
+        } else {
+            nextJoin++;
+            activeCount++;
+        }
+    }
 
-                if (childSizing.type != CLAY__SIZING_TYPE_PERCENT
-                    && childSizing.type != CLAY__SIZING_TYPE_FIXED
-                    && (!Clay__ElementHasConfig(childElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT) || (Clay__FindElementConfigWithType(childElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT).textElementConfig->wrapMode == CLAY_TEXT_WRAP_WORDS)) // todo too many loops
-//                    && (xAxis || !Clay__ElementHasConfig(childElement, CLAY__ELEMENT_CONFIG_TYPE_ASPECT))
-                ) {
-                    Clay__int32_tArray_Add(&resizableContainerBuffer, childElementIndex);
-                }
+    for (int32_t childIndex = 0; childIndex < childBuffer.length; childIndex++) {
+        int32_t childElementIndex = childBuffer.internalArray[childIndex];
+        if (sizes[childElementIndex] * direction >= level) {
+            // Sorted by size, so none of the remaining children rise either
+            break;
+        }
+        sizes[childElementIndex] = CLAY__MIN(level, limits[childElementIndex] * direction) * direction;
+    }
+}
 
-                if (sizingAlongAxis) {
-                    innerContentSize += (childSizing.type == CLAY__SIZING_TYPE_PERCENT ? 0 : childSize);
-                    if (childSizing.type == CLAY__SIZING_TYPE_GROW) {
-                        growContainerCount++;
-                    }
-                    if (childOffset > 0) {
-                        innerContentSize += parentChildGap; // For children after index 0, the childAxisOffset is the gap from the previous child
-                        totalPaddingAndChildGaps += parentChildGap;
-                    }
-                } else {
-                    innerContentSize = CLAY__MAX(childSize, innerContentSize);
-                }
+// Sizes the children of one element along one axis. Children with children of their own are added to bfsBuffer, unless it is NULL.
+// resizableContainerBuffer and resizableLimitBuffer are scratch space for as many elements as the parent has children.
+// Only reads and writes the sizing staging, apart from the layout config of the parent.
+void Clay__SizeChildrenAlongAxis(int32_t parentIndex, bool xAxis, Clay__int32_tArray *bfsBuffer, Clay__int32_tArray resizableContainerBuffer, Clay__int32_tArray resizableLimitBuffer) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (Clay__IncrementalLayoutActive() && Clay__ReuseCachedChildSizes(parentIndex, xAxis, bfsBuffer)) {
+        return;
+    }
+    Clay__SizingAxisStaging *staging = &context->sizingStaging[xAxis ? 0 : 1];
+    float *sizes = staging->sizes.internalArray;
+    float *minSizes = staging->minSizes.internalArray;
+    float *maxSizes = staging->maxSizes.internalArray;
+    Clay__SizingType *sizingTypes = staging->sizingTypes.internalArray;
+    uint8_t *sizingFlags = context->layoutElementSizingFlags.internalArray;
+    uint8_t resizableFlag = xAxis ? CLAY__SIZING_FLAG_RESIZABLE_X : CLAY__SIZING_FLAG_RESIZABLE_Y;
+    uint8_t clipFlag = xAxis ? CLAY__SIZING_FLAG_CLIP_X : CLAY__SIZING_FLAG_CLIP_Y;
+    Clay_LayoutElement *parent = &context->layoutElements.internalArray[parentIndex];
+    Clay_LayoutConfig *parentStyleConfig = parent->layoutConfig;
+    int32_t *children = parent->childrenOrTextContent.children.elements;
+    int32_t childCount = parent->childrenOrTextContent.children.length;
+    int32_t growContainerCount = 0;
+    int32_t percentContainerCount = 0;
+    float parentSize = sizes[parentIndex];
+    float parentPadding = (float)(xAxis ? (parentStyleConfig->padding.left + parentStyleConfig->padding.right) : (parentStyleConfig->padding.top + parentStyleConfig->padding.bottom));
+    float innerContentSize = 0, totalPaddingAndChildGaps = parentPadding;
+    bool sizingAlongAxis = (xAxis && parentStyleConfig->layoutDirection == CLAY_LEFT_TO_RIGHT) || (!xAxis && parentStyleConfig->layoutDirection == CLAY_TOP_TO_BOTTOM);
+    resizableContainerBuffer.length = 0;
+    float parentChildGap = parentStyleConfig->childGap;
+
+    for (int32_t childOffset = 0; childOffset < childCount; childOffset++) {
+        int32_t childElementIndex = children[childOffset];
+        Clay__SizingType childSizingType = sizingTypes[childElementIndex];
+        float childSize = sizes[childElementIndex];
+        uint8_t childFlags = sizingFlags[childElementIndex];
+
+        if (bfsBuffer && (childFlags & CLAY__SIZING_FLAG_HAS_CHILDREN)) {
+            Clay__int32_tArray_Add(bfsBuffer, childElementIndex);
+        }
+
+        if (childFlags & resizableFlag) {
+            Clay__int32_tArray_Add(&resizableContainerBuffer, childElementIndex);
+        }
+
+        if (childSizingType == CLAY__SIZING_TYPE_PERCENT) {
+            percentContainerCount++;
+        }
+        if (sizingAlongAxis) {
+            innerContentSize += (childSizingType == CLAY__SIZING_TYPE_PERCENT ? 0 : childSize);
+            if (childSizingType == CLAY__SIZING_TYPE_GROW) {
+                growContainerCount++;
             }
+            if (childOffset > 0) {
+                innerContentSize += parentChildGap; // For children after index 0, the childAxisOffset is the gap from the previous child
+                totalPaddingAndChildGaps += parentChildGap;
+            }
+        } else {
+            innerContentSize = CLAY__MAX(childSize, innerContentSize);
+        }
+    }
 
-            // Expand percentage containers to size
-            for (int32_t childOffset = 0; childOffset < parent->childrenOrTextContent.children.length; childOffset++) {
-                int32_t childElementIndex = parent->childrenOrTextContent.children.elements[childOffset];
-                Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, childElementIndex);
-                Clay_SizingAxis childSizing = xAxis ? childElement->layoutConfig->sizing.width : childElement->layoutConfig->sizing.height;
-                float *childSize = xAxis ? &childElement->dimensions.width : &childElement->dimensions.height;
-                if (childSizing.type == CLAY__SIZING_TYPE_PERCENT) {
-                    *childSize = (parentSize - totalPaddingAndChildGaps) * childSizing.size.percent;
-                    if (sizingAlongAxis) {
-                        innerContentSize += *childSize;
-                    }
-                    Clay__UpdateAspectRatioBox(childElement);
+    // Expand percentage containers to size
+    for (int32_t childOffset = 0; percentContainerCount > 0 && childOffset < childCount; childOffset++) {
+        int32_t childElementIndex = children[childOffset];
+        if (sizingTypes[childElementIndex] == CLAY__SIZING_TYPE_PERCENT) {
+            sizes[childElementIndex] = (parentSize - totalPaddingAndChildGaps) * maxSizes[childElementIndex];
+            if (sizingAlongAxis) {
+                innerContentSize += sizes[childElementIndex];
+            }
+            if (sizingFlags[childElementIndex] & CLAY__SIZING_FLAG_ASPECT) {
+                Clay__UpdateAspectRatioBox(&context->layoutElements.internalArray[childElementIndex], &context->sizingStaging[0].sizes.internalArray[childElementIndex], &context->sizingStaging[1].sizes.internalArray[childElementIndex]);
+            }
+        }
+    }
+
+    if (sizingAlongAxis) {
+        float sizeToDistribute = parentSize - parentPadding - innerContentSize;
+        // The content is too large, compress the children as much as possible
+        if (sizeToDistribute < 0) {
+            // If the parent clips content in this axis direction, don't compress children, just leave them alone
+            if (sizingFlags[parentIndex] & clipFlag) {
+                return;
+            }
+            if (sizeToDistribute < -CLAY__EPSILON) {
+                Clay__DistributeSizeToChildren(sizes, minSizes, resizableContainerBuffer, resizableLimitBuffer, sizeToDistribute, -1);
+            }
+        // The content is too small, allow SIZING_GROW containers to expand
+        } else if (sizeToDistribute > 0 && growContainerCount > 0) {
+            for (int childIndex = 0; childIndex < resizableContainerBuffer.length; childIndex++) {
+                if (sizingTypes[resizableContainerBuffer.internalArray[childIndex]] != CLAY__SIZING_TYPE_GROW) {
+                    Clay__int32_tArray_RemoveSwapback(&resizableContainerBuffer, childIndex--);
                 }
             }
+            if (sizeToDistribute > CLAY__EPSILON) {
+                Clay__DistributeSizeToChildren(sizes, maxSizes, resizableContainerBuffer, resizableLimitBuffer, sizeToDistribute, 1);
+            }
+        }
+    // Sizing along the non layout axis ("off axis")
+    } else {
+        float maxSize = parentSize - parentPadding;
+        // If we're laying out the children of a scroll panel, grow containers expand to the size of the inner content, not the outer container
+        if (sizingFlags[parentIndex] & clipFlag) {
+            maxSize = CLAY__MAX(maxSize, innerContentSize);
+        }
+        for (int32_t childOffset = 0; childOffset < resizableContainerBuffer.length; childOffset++) {
+            int32_t childElementIndex = resizableContainerBuffer.internalArray[childOffset];
+            float *childSize = &sizes[childElementIndex];
+            if (sizingTypes[childElementIndex] == CLAY__SIZING_TYPE_GROW) {
+                *childSize = CLAY__MIN(maxSize, maxSizes[childElementIndex]);
+            }
+            *childSize = CLAY__MAX(minSizes[childElementIndex], CLAY__MIN(*childSize, maxSize));
+        }
+    }
+}
 
-            if (sizingAlongAxis) {
-                float sizeToDistribute = parentSize - parentPadding - innerContentSize;
-                // The content is too large, compress the children as much as possible
-                if (sizeToDistribute < 0) {
-                    // If the parent clips content in this axis direction, don't compress children, just leave them alone
-                    Clay_ClipElementConfig *clipElementConfig = Clay__FindElementConfigWithType(parent, CLAY__ELEMENT_CONFIG_TYPE_CLIP).clipElementConfig;
-                    if (clipElementConfig) {
-                        if (((xAxis && clipElementConfig->horizontal) || (!xAxis && clipElementConfig->vertical))) {
-                            continue;
-                        }
-                    }
-                    // Scrolling containers preferentially compress before others
-                    while (sizeToDistribute < -CLAY__EPSILON && resizableContainerBuffer.length > 0) {
-                        float largest = 0;
-                        float secondLargest = 0;
-                        float widthToAdd = sizeToDistribute;
-                        for (int childIndex = 0; childIndex < resizableContainerBuffer.length; childIndex++) {
-                            Clay_LayoutElement *child = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(&resizableContainerBuffer, childIndex));
-                            float childSize = xAxis ? child->dimensions.width : child->dimensions.height;
-                            if (Clay__FloatEqual(childSize, largest)) { continue; }
-                            if (childSize > largest) {
-                                secondLargest = largest;
-                                largest = childSize;
-                            }
-                            if (childSize < largest) {
-                                secondLargest = CLAY__MAX(secondLargest, childSize);
-                                widthToAdd = secondLargest - largest;
-                            }
-                        }
+// Sizes the children of each queued element along one axis, queueing their own children in turn (breadth first).
+// Starts at *queueIndex, and when pendingLimit is above 0 stops as soon as that many elements are waiting. *queueIndex is left at the first unprocessed element.
+void Clay__SizeQueuedContainersAlongAxis(bool xAxis, Clay__int32_tArray *bfsBufferQueue, Clay__int32_tArray resizableContainerBuffer, Clay__int32_tArray resizableLimitBuffer, int32_t *queueIndex, int32_t pendingLimit) {
+    Clay__int32_tArray bfsBuffer = *bfsBufferQueue;
+    int32_t i = *queueIndex;
+    for (; i < bfsBuffer.length; ++i) {
+        if (pendingLimit > 0 && bfsBuffer.length - i >= pendingLimit) {
+            break;
+        }
+        Clay__SizeChildrenAlongAxis(bfsBuffer.internalArray[i], xAxis, &bfsBuffer, resizableContainerBuffer, resizableLimitBuffer);
+    }
+    *queueIndex = i;
+    *bfsBufferQueue = bfsBuffer;
+}
 
-                        widthToAdd = CLAY__MAX(widthToAdd, sizeToDistribute / resizableContainerBuffer.length);
-
-                        for (int childIndex = 0; childIndex < resizableContainerBuffer.length; childIndex++) {
-                            Clay_LayoutElement *child = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(&resizableContainerBuffer, childIndex));
-                            float *childSize = xAxis ? &child->dimensions.width : &child->dimensions.height;
-                            float minSize = xAxis ? child->minDimensions.width : child->minDimensions.height;
-                            float previousWidth = *childSize;
-                            if (Clay__FloatEqual(*childSize, largest)) {
-                                *childSize += widthToAdd;
-                                if (*childSize <= minSize) {
-                                    *childSize = minSize;
-                                    Clay__int32_tArray_RemoveSwapback(&resizableContainerBuffer, childIndex--);
-                                }
-                                sizeToDistribute -= (*childSize - previousWidth);
-                            }
-                        }
-                    }
-                // The content is too small, allow SIZING_GROW containers to expand
-                } else if (sizeToDistribute > 0 && growContainerCount > 0) {
-                    for (int childIndex = 0; childIndex < resizableContainerBuffer.length; childIndex++) {
-                        Clay_LayoutElement *child = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(&resizableContainerBuffer, childIndex));
-                        Clay__SizingType childSizing = xAxis ? child->layoutConfig->sizing.width.type : child->layoutConfig->sizing.height.type;
-                        if (childSizing != CLAY__SIZING_TYPE_GROW) {
-                            Clay__int32_tArray_RemoveSwapback(&resizableContainerBuffer, childIndex--);
-                        }
-                    }
-                    while (sizeToDistribute > CLAY__EPSILON && resizableContainerBuffer.length > 0) {
-                        float smallest = CLAY__MAXFLOAT;
-                        float secondSmallest = CLAY__MAXFLOAT;
-                        float widthToAdd = sizeToDistribute;
-                        for (int childIndex = 0; childIndex < resizableContainerBuffer.length; childIndex++) {
-                            Clay_LayoutElement *child = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(&resizableContainerBuffer, childIndex));
-                            float childSize = xAxis ? child->dimensions.width : child->dimensions.height;
-                            if (Clay__FloatEqual(childSize, smallest)) { continue; }
-                            if (childSize < smallest) {
-                                secondSmallest = smallest;
-                                smallest = childSize;
-                            }
-                            if (childSize > smallest) {
-                                secondSmallest = CLAY__MIN(secondSmallest, childSize);
-                                widthToAdd = secondSmallest - smallest;
-                            }
-                        }
+// Sizes every element below layoutElementIndex along one axis. Walks the subtree in declaration order, which visits every parent before its children,
+// and skips the floating elements declared inside it, they are sized as tree roots of their own.
+void Clay__SizeSubtreeAlongAxis(int32_t layoutElementIndex, bool xAxis, Clay__int32_tArray resizableContainerBuffer, Clay__int32_tArray resizableLimitBuffer) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    uint8_t *sizingFlags = context->layoutElementSizingFlags.internalArray;
+    int32_t *subtreeSizes = context->layoutElementSubtreeSizes.internalArray;
+    int32_t subtreeEnd = layoutElementIndex + subtreeSizes[layoutElementIndex];
+    for (int32_t i = layoutElementIndex; i < subtreeEnd; ++i) {
+        uint8_t flags = sizingFlags[i];
+        if ((flags & CLAY__SIZING_FLAG_FLOATING) && i != layoutElementIndex) {
+            i += subtreeSizes[i] - 1;
+            continue;
+        }
+        if (flags & CLAY__SIZING_FLAG_HAS_CHILDREN) {
+            Clay__SizeChildrenAlongAxis(i, xAxis, NULL, resizableContainerBuffer, resizableLimitBuffer);
+        }
+    }
+}
 
-                        widthToAdd = CLAY__MIN(widthToAdd, sizeToDistribute / resizableContainerBuffer.length);
-
-                        for (int childIndex = 0; childIndex < resizableContainerBuffer.length; childIndex++) {
-                            Clay_LayoutElement *child = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(&resizableContainerBuffer, childIndex));
-                            float *childSize = xAxis ? &child->dimensions.width : &child->dimensions.height;
-                            float maxSize = xAxis ? child->layoutConfig->sizing.width.size.minMax.max : child->layoutConfig->sizing.height.size.minMax.max;
-                            float previousWidth = *childSize;
-                            if (Clay__FloatEqual(*childSize, smallest)) {
-                                *childSize += widthToAdd;
-                                if (*childSize >= maxSize) {
-                                    *childSize = maxSize;
-                                    Clay__int32_tArray_RemoveSwapback(&resizableContainerBuffer, childIndex--);
-                                }
-                                sizeToDistribute -= (*childSize - previousWidth);
-                            }
-                        }
-                    }
-                }
-            // Sizing along the non layout axis ("off axis")
-            } else {
-                for (int32_t childOffset = 0; childOffset < resizableContainerBuffer.length; childOffset++) {
-                    Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(&resizableContainerBuffer, childOffset));
-                    Clay_SizingAxis childSizing = xAxis ? childElement->layoutConfig->sizing.width : childElement->layoutConfig->sizing.height;
-                    float minSize = xAxis ? childElement->minDimensions.width : childElement->minDimensions.height;
-                    float *childSize = xAxis ? &childElement->dimensions.width : &childElement->dimensions.height;
-
-                    float maxSize = parentSize - parentPadding;
-                    // If we're laying out the children of a scroll panel, grow containers expand to the size of the inner content, not the outer container
-                    if (Clay__ElementHasConfig(parent, CLAY__ELEMENT_CONFIG_TYPE_CLIP)) {
-                        Clay_ClipElementConfig *clipElementConfig = Clay__FindElementConfigWithType(parent, CLAY__ELEMENT_CONFIG_TYPE_CLIP).clipElementConfig;
-                        if (((xAxis && clipElementConfig->horizontal) || (!xAxis && clipElementConfig->vertical))) {
-                            maxSize = CLAY__MAX(maxSize, innerContentSize);
-                        }
-                    }
-                    if (childSizing.type == CLAY__SIZING_TYPE_GROW) {
-                        *childSize = CLAY__MIN(maxSize, childSizing.size.minMax.max);
+bool Clay__ParallelLayoutAvailable(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    // Subtree sizes are only meaningful if every element was opened and closed normally this frame
+    return !context->booleanWarnings.maxElementsExceeded && context->openLayoutElementStack.length <= 1;
+}
+
+// Records which tree root every element belongs to, and how many elements each element's subtree holds (floating children excluded)
+void Clay__PrepareParallelLayout(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    int32_t elementCount = context->layoutElements.length;
+    int32_t *treeSizes = context->layoutElementTreeSizes.internalArray;
+    int32_t *rootIndexes = context->layoutElementRootIndexes.internalArray;
+    uint8_t *sizingFlags = context->layoutElementSizingFlags.internalArray;
+    int32_t *subtreeSizes = context->layoutElementSubtreeSizes.internalArray;
+    context->layoutElementTreeSizes.length = elementCount;
+    context->layoutElementRootIndexes.length = elementCount;
+    // Floating roots are added as they are declared, so a root declared inside another one comes after it and overwrites its own part of the range
+    for (int32_t rootIndex = 0; rootIndex < context->layoutElementTreeRoots.length; ++rootIndex) {
+        int32_t rootElementIndex = (int32_t)context->layoutElementTreeRoots.internalArray[rootIndex].layoutElementIndex;
+        for (int32_t i = rootElementIndex; i < rootElementIndex + subtreeSizes[rootElementIndex]; ++i) {
+            rootIndexes[i] = rootIndex;
+        }
+    }
+    for (int32_t i = elementCount - 1; i >= 0; --i) {
+        Clay_LayoutElement *element = &context->layoutElements.internalArray[i];
+        treeSizes[i] = 1;
+        if (!(sizingFlags[i] & CLAY__SIZING_FLAG_HAS_CHILDREN)) continue;
+        for (int32_t j = 0; j < element->childrenOrTextContent.children.length; ++j) {
+            treeSizes[i] += treeSizes[element->childrenOrTextContent.children.elements[j]];
+        }
+    }
+}
+
+// Returns the index of the tree root whose sizes this root reads in Clay__SizeRootElement, or -1 if it doesn't depend on another root
+int32_t Clay__GetTreeRootDependency(int32_t rootIndex) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, rootIndex);
+    Clay_LayoutElement *rootElement = Clay_LayoutElementArray_Get(&context->layoutElements, (int)root->layoutElementIndex);
+    if (!Clay__ElementHasConfig(rootElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING)) {
+        return -1;
+    }
+    Clay__SizingType widthType = rootElement->layoutConfig->sizing.width.type;
+    Clay__SizingType heightType = rootElement->layoutConfig->sizing.height.type;
+    if (widthType != CLAY__SIZING_TYPE_GROW && widthType != CLAY__SIZING_TYPE_PERCENT && heightType != CLAY__SIZING_TYPE_GROW && heightType != CLAY__SIZING_TYPE_PERCENT) {
+        return -1;
+    }
+    Clay_FloatingElementConfig *floatingElementConfig = Clay__FindElementConfigWithType(rootElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING).floatingElementConfig;
+    Clay_LayoutElementHashMapItem *parentItem = Clay__GetHashMapItem(floatingElementConfig->parentId);
+    if (!parentItem || parentItem == &Clay_LayoutElementHashMapItem_DEFAULT) {
+        return -1;
+    }
+    int32_t parentIndex = (int32_t)(parentItem->layoutElement - context->layoutElements.internalArray);
+    if (parentIndex < 0 || parentIndex >= context->layoutElements.length) {
+        // Not an element from this frame, wait for every root before this one to be safe
+        return rootIndex - 1;
+    }
+    return context->layoutElementRootIndexes.internalArray[parentIndex];
+}
+
+void Clay__RunSizingTask(int32_t taskIndex, void *taskData) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    bool xAxis = *(bool *)taskData;
+    Clay__SizingTask *task = &context->sizingTasks.internalArray[taskIndex];
+    Clay__int32_tArray resizableContainerBuffer = { .capacity = task->bufferCapacity, .internalArray = context->openLayoutElementStack.internalArray + task->bufferOffset };
+    Clay__int32_tArray resizableLimitBuffer = { .capacity = task->bufferCapacity, .internalArray = context->resizableLimitBuffer.internalArray + task->bufferOffset };
+    if (task->treeRootCount == 0) {
+        Clay__SizeSubtreeAlongAxis(task->layoutElementIndex, xAxis, resizableContainerBuffer, resizableLimitBuffer);
+        return;
+    }
+    for (int32_t rootIndex = task->treeRootIndex; rootIndex < task->treeRootIndex + task->treeRootCount; ++rootIndex) {
+        Clay__SizeSubtreeAlongAxis((int32_t)context->layoutElementTreeRoots.internalArray[rootIndex].layoutElementIndex, xAxis, resizableContainerBuffer, resizableLimitBuffer);
+    }
+}
+
+// Roots are handed out in batches of consecutive roots, where no root reads the size of another root in the same batch.
+// Large roots are expanded breadth first until enough subtrees are waiting, then every waiting subtree becomes its own task.
+// Each task gets a slice of the scratch buffers as large as its subtree, so the slices of a batch never overlap.
+void Clay__SizeContainersAlongAxisParallel(bool xAxis) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    // The x axis is always sized first, and the tree doesn't change before the y axis
+    if (xAxis) {
+        Clay__PrepareParallelLayout();
+    }
+    int32_t *treeSizes = context->layoutElementTreeSizes.internalArray;
+    int32_t batchStart = 0;
+    while (batchStart < context->layoutElementTreeRoots.length) {
+        int32_t batchEnd = batchStart + 1;
+        while (batchEnd < context->layoutElementTreeRoots.length && Clay__GetTreeRootDependency(batchEnd) < batchStart) {
+            batchEnd++;
+        }
+
+        context->sizingTasks.length = 0;
+        int32_t bufferOffset = 0;
+        for (int32_t rootIndex = batchStart; rootIndex < batchEnd; ++rootIndex) {
+            Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, rootIndex);
+            int32_t treeSize = treeSizes[root->layoutElementIndex];
+            Clay__SizeRootElement(root);
+            if (treeSize < CLAY__PARALLEL_SPLIT_MIN_ELEMENTS) {
+                // The roots of a group are sized one after the other, so the group's slice only needs to fit the largest of them
+                Clay__SizingTask *group = context->sizingTasks.length > 0 ? &context->sizingTasks.internalArray[context->sizingTasks.length - 1] : NULL;
+                if (group && group->treeRootCount > 0 && group->elementCount < CLAY__PARALLEL_TASK_MIN_ELEMENTS) {
+                    group->treeRootCount++;
+                    group->elementCount += treeSize;
+                    if (treeSize > group->bufferCapacity) {
+                        bufferOffset += treeSize - group->bufferCapacity;
+                        group->bufferCapacity = treeSize;
                     }
-                    *childSize = CLAY__MAX(minSize, CLAY__MIN(*childSize, maxSize));
+                } else {
+                    Clay__SizingTaskArray_Add(&context->sizingTasks, CLAY__INIT(Clay__SizingTask) { rootIndex, 1, (int32_t)root->layoutElementIndex, treeSize, bufferOffset, treeSize });
+                    bufferOffset += treeSize;
                 }
+                continue;
             }
+            Clay__int32_tArray bfsBuffer = { .capacity = treeSize, .internalArray = context->layoutElementChildrenBuffer.internalArray + bufferOffset };
+            Clay__int32_tArray resizableContainerBuffer = { .capacity = treeSize, .internalArray = context->openLayoutElementStack.internalArray + bufferOffset };
+            Clay__int32_tArray resizableLimitBuffer = { .capacity = treeSize, .internalArray = context->resizableLimitBuffer.internalArray + bufferOffset };
+            Clay__int32_tArray_Add(&bfsBuffer, (int32_t)root->layoutElementIndex);
+            int32_t queueIndex = 0;
+            Clay__SizeQueuedContainersAlongAxis(xAxis, &bfsBuffer, resizableContainerBuffer, resizableLimitBuffer, &queueIndex, CLAY__PARALLEL_SPLIT_TASK_COUNT);
+            // The waiting subtrees are disjoint and together smaller than the root, so they can share its slice
+            int32_t subtreeOffset = bufferOffset;
+            for (int32_t i = queueIndex; i < bfsBuffer.length; ++i) {
+                int32_t layoutElementIndex = bfsBuffer.internalArray[i];
+                Clay__SizingTaskArray_Add(&context->sizingTasks, CLAY__INIT(Clay__SizingTask) { 0, 0, layoutElementIndex, treeSizes[layoutElementIndex], subtreeOffset, treeSizes[layoutElementIndex] });
+                subtreeOffset += treeSizes[layoutElementIndex];
+            }
+            bufferOffset += treeSize;
+        }
+
+        if (context->sizingTasks.length == 1) {
+            Clay__RunSizingTask(0, &xAxis);
+        } else if (context->sizingTasks.length > 1) {
+            context->parallelForFunction(context->sizingTasks.length, Clay__RunSizingTask, &xAxis, context->parallelForUserData);
         }
+        batchStart = batchEnd;
+    }
+}
+
+void Clay__SizeContainersAlongAxis(bool xAxis) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context->parallelForFunction && Clay__ParallelLayoutAvailable()) {
+        Clay__SizeContainersAlongAxisParallel(xAxis);
+        return;
+    }
+    Clay__int32_tArray resizableContainerBuffer = context->openLayoutElementStack;
+    Clay__int32_tArray resizableLimitBuffer = context->resizableLimitBuffer;
+    for (int32_t rootIndex = 0; rootIndex < context->layoutElementTreeRoots.length; ++rootIndex) {
+        Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, rootIndex);
+        Clay__SizeRootElement(root);
+        Clay__SizeSubtreeAlongAxis((int32_t)root->layoutElementIndex, xAxis, resizableContainerBuffer, resizableLimitBuffer);
     }
 }
 
@@ -2528,8 +3730,29 @@ bool Clay__ElementIsOffscreen(Clay_BoundingBox *boundingBox) {
            (boundingBox->y + boundingBox->height < 0);
 }
 
-void Clay__CalculateFinalLayout(void) {
+// Calculates the final dimensions of every element and wraps text
+void Clay__SizeLayoutElements(void) {
     Clay_Context* context = Clay_GetCurrentContext();
+    Clay__SizingAxisStaging *stagingY = &context->sizingStaging[1];
+    float *widths = context->sizingStaging[0].sizes.internalArray;
+    float *heights = stagingY->sizes.internalArray;
+    for (int32_t axis = 0; axis < 2; ++axis) {
+        context->sizingStaging[axis].sizes.length = context->layoutElements.length;
+        context->sizingStaging[axis].minSizes.length = context->layoutElements.length;
+        context->sizingStaging[axis].maxSizes.length = context->layoutElements.length;
+        context->sizingStaging[axis].sizingTypes.length = context->layoutElements.length;
+    }
+    context->layoutElementSizingFlags.length = context->layoutElements.length;
+    // Elements left open by an unbalanced layout were never staged, their subtrees run to the last element
+    if (context->openLayoutElementStack.length > 1) {
+        for (int32_t i = 0; i < context->layoutElements.length; ++i) {
+            Clay__StageLayoutElementSizing(i);
+        }
+        for (int32_t i = 0; i < context->openLayoutElementStack.length; ++i) {
+            int32_t openElementIndex = context->openLayoutElementStack.internalArray[i];
+            Clay__int32_tArray_Set(&context->layoutElementSubtreeSizes, openElementIndex, context->layoutElements.length - openElementIndex);
+        }
+    }
     // Calculate sizing along the X axis
     Clay__SizeContainersAlongAxis(true);
 
@@ -2538,14 +3761,15 @@ void Clay__CalculateFinalLayout(void) {
         Clay__TextElementData *textElementData = Clay__TextElementDataArray_Get(&context->textElementData, textElementIndex);
         textElementData->wrappedLines = CLAY__INIT(Clay__WrappedTextLineArraySlice) { .length = 0, .internalArray = &context->wrappedTextLines.internalArray[context->wrappedTextLines.length] };
         Clay_LayoutElement *containerElement = Clay_LayoutElementArray_Get(&context->layoutElements, (int)textElementData->elementIndex);
+        float containerWidth = widths[textElementData->elementIndex];
         Clay_TextElementConfig *textConfig = Clay__FindElementConfigWithType(containerElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT).textElementConfig;
         Clay__MeasureTextCacheItem *measureTextCacheItem = Clay__MeasureTextCached(&textElementData->text, textConfig);
         float lineWidth = 0;
         float lineHeight = textConfig->lineHeight > 0 ? (float)textConfig->lineHeight : textElementData->preferredDimensions.height;
         int32_t lineLengthChars = 0;
         int32_t lineStartOffset = 0;
-        if (!measureTextCacheItem->containsNewlines && textElementData->preferredDimensions.width <= containerElement->dimensions.width) {
-            Clay__WrappedTextLineArray_Add(&context->wrappedTextLines, CLAY__INIT(Clay__WrappedTextLine) { containerElement->dimensions,  textElementData->text });
+        if (!measureTextCacheItem->containsNewlines && textElementData->preferredDimensions.width <= containerWidth) {
+            Clay__WrappedTextLineArray_Add(&context->wrappedTextLines, CLAY__INIT(Clay__WrappedTextLine) { { containerWidth, heights[textElementData->elementIndex] },  textElementData->text });
             textElementData->wrappedLines.length++;
             continue;
         }
@@ -2557,14 +3781,14 @@ void Clay__CalculateFinalLayout(void) {
             }
             Clay__MeasuredWord *measuredWord = Clay__MeasuredWordArray_Get(&context->measuredWords, wordIndex);
             // Only word on the line is too large, just render it anyway
-            if (lineLengthChars == 0 && lineWidth + measuredWord->width > containerElement->dimensions.width) {
+            if (lineLengthChars == 0 && lineWidth + measuredWord->width > containerWidth) {
                 Clay__WrappedTextLineArray_Add(&context->wrappedTextLines, CLAY__INIT(Clay__WrappedTextLine) { { measuredWord->width, lineHeight }, { .length = measuredWord->length, .chars = &textElementData->text.chars[measuredWord->startOffset] } });
                 textElementData->wrappedLines.length++;
                 wordIndex = measuredWord->next;
                 lineStartOffset = measuredWord->startOffset + measuredWord->length;
             }
             // measuredWord->length == 0 means a newline character
-            else if (measuredWord->length == 0 || lineWidth + measuredWord->width > containerElement->dimensions.width) {
+            else if (measuredWord->length == 0 || lineWidth + measuredWord->width > containerWidth) {
                 // Wrapped text lines list has overflowed, just render out the line
                 bool finalCharIsSpace = textElementData->text.chars[CLAY__MAX(lineStartOffset + lineLengthChars - 1, 0)] == ' ';
                 Clay__WrappedTextLineArray_Add(&context->wrappedTextLines, CLAY__INIT(Clay__WrappedTextLine) { { lineWidth + (finalCharIsSpace ? -spaceWidth : 0), lineHeight }, { .length = lineLengthChars + (finalCharIsSpace ? -1 : 0), .chars = &textElementData->text.chars[lineStartOffset] } });
@@ -2585,62 +3809,46 @@ void Clay__CalculateFinalLayout(void) {
             Clay__WrappedTextLineArray_Add(&context->wrappedTextLines, CLAY__INIT(Clay__WrappedTextLine) { { lineWidth - textConfig->letterSpacing, lineHeight }, {.length = lineLengthChars, .chars = &textElementData->text.chars[lineStartOffset] } });
             textElementData->wrappedLines.length++;
         }
-        containerElement->dimensions.height = lineHeight * (float)textElementData->wrappedLines.length;
+        heights[textElementData->elementIndex] = lineHeight * (float)textElementData->wrappedLines.length;
     }
 
     // Scale vertical heights according to aspect ratio
     for (int32_t i = 0; i < context->aspectRatioElementIndexes.length; ++i) {
-        Clay_LayoutElement* aspectElement = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(&context->aspectRatioElementIndexes, i));
+        int32_t aspectElementIndex = Clay__int32_tArray_GetValue(&context->aspectRatioElementIndexes, i);
+        Clay_LayoutElement* aspectElement = Clay_LayoutElementArray_Get(&context->layoutElements, aspectElementIndex);
         Clay_AspectRatioElementConfig *config = Clay__FindElementConfigWithType(aspectElement, CLAY__ELEMENT_CONFIG_TYPE_ASPECT).aspectRatioElementConfig;
-        aspectElement->dimensions.height = (1 / config->aspectRatio) * aspectElement->dimensions.width;
-        aspectElement->layoutConfig->sizing.height.size.minMax.max = aspectElement->dimensions.height;
+        heights[aspectElementIndex] = (1 / config->aspectRatio) * widths[aspectElementIndex];
+        aspectElement->layoutConfig->sizing.height.size.minMax.max = heights[aspectElementIndex];
+        if (stagingY->sizingTypes.internalArray[aspectElementIndex] != CLAY__SIZING_TYPE_PERCENT) {
+            stagingY->maxSizes.internalArray[aspectElementIndex] = heights[aspectElementIndex];
+        }
     }
 
-    // Propagate effect of text wrapping, aspect scaling etc. on height of parents
-    Clay__LayoutElementTreeNodeArray dfsBuffer = context->layoutElementTreeNodeArray1;
-    dfsBuffer.length = 0;
-    for (int32_t i = 0; i < context->layoutElementTreeRoots.length; ++i) {
-        Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, i);
-        context->treeNodeVisited.internalArray[dfsBuffer.length] = false;
-        Clay__LayoutElementTreeNodeArray_Add(&dfsBuffer, CLAY__INIT(Clay__LayoutElementTreeNode) { .layoutElement = Clay_LayoutElementArray_Get(&context->layoutElements, (int)root->layoutElementIndex) });
-    }
-    while (dfsBuffer.length > 0) {
-        Clay__LayoutElementTreeNode *currentElementTreeNode = Clay__LayoutElementTreeNodeArray_Get(&dfsBuffer, (int)dfsBuffer.length - 1);
-        Clay_LayoutElement *currentElement = currentElementTreeNode->layoutElement;
-        if (!context->treeNodeVisited.internalArray[dfsBuffer.length - 1]) {
-            context->treeNodeVisited.internalArray[dfsBuffer.length - 1] = true;
-            // If the element has no children or is the container for a text element, don't bother inspecting it
-            if (Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT) || currentElement->childrenOrTextContent.children.length == 0) {
-                dfsBuffer.length--;
-                continue;
-            }
-            // Add the children to the DFS buffer (needs to be pushed in reverse so that stack traversal is in correct layout order)
-            for (int32_t i = 0; i < currentElement->childrenOrTextContent.children.length; i++) {
-                context->treeNodeVisited.internalArray[dfsBuffer.length] = false;
-                Clay__LayoutElementTreeNodeArray_Add(&dfsBuffer, CLAY__INIT(Clay__LayoutElementTreeNode) { .layoutElement = Clay_LayoutElementArray_Get(&context->layoutElements, currentElement->childrenOrTextContent.children.elements[i]) });
-            }
+    // Propagate effect of text wrapping, aspect scaling etc. on height of parents.
+    // Children are always declared after their parents, so walking the elements backwards reaches every child before its parent.
+    uint8_t *sizingFlags = context->layoutElementSizingFlags.internalArray;
+    for (int32_t elementIndex = context->layoutElements.length - 1; elementIndex >= 0; --elementIndex) {
+        // If the element has no children or is the container for a text element, don't bother inspecting it
+        if (!(sizingFlags[elementIndex] & CLAY__SIZING_FLAG_HAS_CHILDREN)) {
             continue;
         }
-        dfsBuffer.length--;
-
-        // DFS node has been visited, this is on the way back up to the root
+        Clay_LayoutElement *currentElement = &context->layoutElements.internalArray[elementIndex];
         Clay_LayoutConfig *layoutConfig = currentElement->layoutConfig;
+        float *currentHeight = &heights[elementIndex];
         if (layoutConfig->layoutDirection == CLAY_LEFT_TO_RIGHT) {
             // Resize any parent containers that have grown in height along their non layout axis
             for (int32_t j = 0; j < currentElement->childrenOrTextContent.children.length; ++j) {
-                Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, currentElement->childrenOrTextContent.children.elements[j]);
-                float childHeightWithPadding = CLAY__MAX(childElement->dimensions.height + layoutConfig->padding.top + layoutConfig->padding.bottom, currentElement->dimensions.height);
-                currentElement->dimensions.height = CLAY__MIN(CLAY__MAX(childHeightWithPadding, layoutConfig->sizing.height.size.minMax.min), layoutConfig->sizing.height.size.minMax.max);
+                float childHeightWithPadding = CLAY__MAX(heights[currentElement->childrenOrTextContent.children.elements[j]] + layoutConfig->padding.top + layoutConfig->padding.bottom, *currentHeight);
+                *currentHeight = CLAY__MIN(CLAY__MAX(childHeightWithPadding, layoutConfig->sizing.height.size.minMax.min), layoutConfig->sizing.height.size.minMax.max);
             }
         } else if (layoutConfig->layoutDirection == CLAY_TOP_TO_BOTTOM) {
             // Resizing along the layout axis
             float contentHeight = (float)(layoutConfig->padding.top + layoutConfig->padding.bottom);
             for (int32_t j = 0; j < currentElement->childrenOrTextContent.children.length; ++j) {
-                Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, currentElement->childrenOrTextContent.children.elements[j]);
-                contentHeight += childElement->dimensions.height;
+                contentHeight += heights[currentElement->childrenOrTextContent.children.elements[j]];
             }
             contentHeight += (float)(CLAY__MAX(currentElement->childrenOrTextContent.children.length - 1, 0) * layoutConfig->childGap);
-            currentElement->dimensions.height = CLAY__MIN(CLAY__MAX(contentHeight, layoutConfig->sizing.height.size.minMax.min), layoutConfig->sizing.height.size.minMax.max);
+            *currentHeight = CLAY__MIN(CLAY__MAX(contentHeight, layoutConfig->sizing.height.size.minMax.min), layoutConfig->sizing.height.size.minMax.max);
         }
     }
 
@@ -2649,27 +3857,30 @@ void Clay__CalculateFinalLayout(void) {
 
     // Scale horizontal widths according to aspect ratio
     for (int32_t i = 0; i < context->aspectRatioElementIndexes.length; ++i) {
-        Clay_LayoutElement* aspectElement = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(&context->aspectRatioElementIndexes, i));
+        int32_t aspectElementIndex = Clay__int32_tArray_GetValue(&context->aspectRatioElementIndexes, i);
+        Clay_LayoutElement* aspectElement = Clay_LayoutElementArray_Get(&context->layoutElements, aspectElementIndex);
         Clay_AspectRatioElementConfig *config = Clay__FindElementConfigWithType(aspectElement, CLAY__ELEMENT_CONFIG_TYPE_ASPECT).aspectRatioElementConfig;
-        aspectElement->dimensions.width = config->aspectRatio * aspectElement->dimensions.height;
+        widths[aspectElementIndex] = config->aspectRatio * heights[aspectElementIndex];
     }
+    Clay__StoreStagedSizes();
 
-    // Sort tree roots by z-index
-    int32_t sortMax = context->layoutElementTreeRoots.length - 1;
-    while (sortMax > 0) { // todo dumb bubble sort
-        for (int32_t i = 0; i < sortMax; ++i) {
-            Clay__LayoutElementTreeRoot current = *Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, i);
-            Clay__LayoutElementTreeRoot next = *Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, i + 1);
-            if (next.zIndex < current.zIndex) {
-                Clay__LayoutElementTreeRootArray_Set(&context->layoutElementTreeRoots, i, next);
-                Clay__LayoutElementTreeRootArray_Set(&context->layoutElementTreeRoots, i + 1, current);
-            }
-        }
-        sortMax--;
+    if (Clay__IncrementalLayoutActive()) {
+        Clay__StoreIncrementalLayoutResults();
     }
+}
+
+void Clay__CalculateFinalLayout(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (!Clay__IncrementalLayoutActive() || !Clay__ReuseLastLayoutSizes()) {
+        Clay__SizeLayoutElements();
+    }
+
+    // Sort tree roots by z-index
+    Clay__SortLayoutElementTreeRoots();
 
     // Calculate final positions and generate render commands
     context->renderCommands.length = 0;
+    Clay__LayoutElementTreeNodeArray dfsBuffer = context->layoutElementTreeNodeArray1;
     dfsBuffer.length = 0;
     for (int32_t rootIndex = 0; rootIndex < context->layoutElementTreeRoots.length; ++rootIndex) {
         dfsBuffer.length = 0;
@@ -2802,23 +4013,26 @@ void Clay__CalculateFinalLayout(void) {
                     hashMapItem->boundingBox = currentElementBoundingBox;
                 }
 
+                // Clip configs go first and border configs last, so scissoring starts before anything is drawn and borders end up on top.
+                // Every other config keeps its declaration order.
                 int32_t sortedConfigIndexes[20];
+                int32_t sortedConfigCount = 0;
+                int32_t borderConfigIndex = -1;
                 for (int32_t elementConfigIndex = 0; elementConfigIndex < currentElement->elementConfigs.length; ++elementConfigIndex) {
-                    sortedConfigIndexes[elementConfigIndex] = elementConfigIndex;
+                    if (Clay__ElementConfigArraySlice_Get(&currentElement->elementConfigs, elementConfigIndex)->type == CLAY__ELEMENT_CONFIG_TYPE_CLIP) {
+                        sortedConfigIndexes[sortedConfigCount++] = elementConfigIndex;
+                    }
                 }
-                sortMax = currentElement->elementConfigs.length - 1;
-                while (sortMax > 0) { // todo dumb bubble sort
-                    for (int32_t i = 0; i < sortMax; ++i) {
-                        int32_t current = sortedConfigIndexes[i];
-                        int32_t next = sortedConfigIndexes[i + 1];
-                        Clay__ElementConfigType currentType = Clay__ElementConfigArraySlice_Get(&currentElement->elementConfigs, current)->type;
-                        Clay__ElementConfigType nextType = Clay__ElementConfigArraySlice_Get(&currentElement->elementConfigs, next)->type;
-                        if (nextType == CLAY__ELEMENT_CONFIG_TYPE_CLIP || currentType == CLAY__ELEMENT_CONFIG_TYPE_BORDER) {
-                            sortedConfigIndexes[i] = next;
-                            sortedConfigIndexes[i + 1] = current;
-                        }
+                for (int32_t elementConfigIndex = 0; elementConfigIndex < currentElement->elementConfigs.length; ++elementConfigIndex) {
+                    Clay__ElementConfigType configType = Clay__ElementConfigArraySlice_Get(&currentElement->elementConfigs, elementConfigIndex)->type;
+                    if (configType == CLAY__ELEMENT_CONFIG_TYPE_BORDER) {
+                        borderConfigIndex = elementConfigIndex;
+                    } else if (configType != CLAY__ELEMENT_CONFIG_TYPE_CLIP) {
+                        sortedConfigIndexes[sortedConfigCount++] = elementConfigIndex;
                     }
-                    sortMax--;
+                }
+                if (borderConfigIndex != -1) {
+                    sortedConfigIndexes[sortedConfigCount++] = borderConfigIndex;
                 }
 
                 bool emitRectangle = false;
@@ -2962,7 +4176,7 @@ void Clay__CalculateFinalLayout(void) {
                     Clay_Dimensions contentSize = {0,0};
                     if (layoutConfig->layoutDirection == CLAY_LEFT_TO_RIGHT) {
                         for (int32_t i = 0; i < currentElement->childrenOrTextContent.children.length; ++i) {
-                            Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, currentElement->childrenOrTextContent.children.elements[i]);
+                            Clay_LayoutElement *childElement = &context->layoutElements.internalArray[currentElement->childrenOrTextContent.children.elements[i]];
                             contentSize.width += childElement->dimensions.width;
                             contentSize.height = CLAY__MAX(contentSize.height, childElement->dimensions.height);
                         }
@@ -2977,7 +4191,7 @@ void Clay__CalculateFinalLayout(void) {
                         extraSpace = CLAY__MAX(0, extraSpace);
                     } else {
                         for (int32_t i = 0; i < currentElement->childrenOrTextContent.children.length; ++i) {
-                            Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, currentElement->childrenOrTextContent.children.elements[i]);
+                            Clay_LayoutElement *childElement = &context->layoutElements.internalArray[currentElement->childrenOrTextContent.children.elements[i]];
                             contentSize.width = CLAY__MAX(contentSize.width, childElement->dimensions.width);
                             contentSize.height += childElement->dimensions.height;
                         }
@@ -3040,7 +4254,7 @@ void Clay__CalculateFinalLayout(void) {
                             Clay_Vector2 borderOffset = { (float)layoutConfig->padding.left - halfGap, (float)layoutConfig->padding.top - halfGap };
                             if (layoutConfig->layoutDirection == CLAY_LEFT_TO_RIGHT) {
                                 for (int32_t i = 0; i < currentElement->childrenOrTextContent.children.length; ++i) {
-                                    Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, currentElement->childrenOrTextContent.children.elements[i]);
+                                    Clay_LayoutElement *childElement = &context->layoutElements.internalArray[currentElement->childrenOrTextContent.children.elements[i]];
                                     if (i > 0) {
                                         Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand) {
                                             .boundingBox = { currentElementBoundingBox.x + borderOffset.x + scrollOffset.x, currentElementBoundingBox.y + scrollOffset.y, (float)borderConfig->width.betweenChildren, currentElement->dimensions.height },
@@ -3056,7 +4270,7 @@ void Clay__CalculateFinalLayout(void) {
                                 }
                             } else {
                                 for (int32_t i = 0; i < currentElement->childrenOrTextContent.children.length; ++i) {
-                                    Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, currentElement->childrenOrTextContent.children.elements[i]);
+                                    Clay_LayoutElement *childElement = &context->layoutElements.internalArray[currentElement->childrenOrTextContent.children.elements[i]];
                                     if (i > 0) {
                                         Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand) {
                                             .boundingBox = { currentElementBoundingBox.x + scrollOffset.x, currentElementBoundingBox.y + borderOffset.y + scrollOffset.y, currentElement->dimensions.width, (float)borderConfig->width.betweenChildren },
@@ -3090,7 +4304,7 @@ void Clay__CalculateFinalLayout(void) {
             if (!Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT)) {
                 dfsBuffer.length += currentElement->childrenOrTextContent.children.length;
                 for (int32_t i = 0; i < currentElement->childrenOrTextContent.children.length; ++i) {
-                    Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, currentElement->childrenOrTextContent.children.elements[i]);
+                    Clay_LayoutElement *childElement = &context->layoutElements.internalArray[currentElement->childrenOrTextContent.children.elements[i]];
                     // Alignment along non layout axis
                     if (layoutConfig->layoutDirection == CLAY_LEFT_TO_RIGHT) {
                         currentElementTreeNode->nextChildOffset.y = currentElement->layoutConfig->padding.top;
@@ -3224,6 +4438,7 @@ Clay__RenderDebugLayoutData Clay__RenderDebugLayoutElementsList(int32_t initialR
 
             context->treeNodeVisited.internalArray[dfsBuffer.length - 1] = true;
             Clay_LayoutElementHashMapItem *currentElementData = Clay__GetHashMapItem(currentElement->id);
+            Clay__LayoutElementHashMapItemCold *currentElementColdData = Clay__GetHashMapItemCold(currentElementData);
             bool offscreen = Clay__ElementIsOffscreen(&currentElementData->boundingBox);
             if (context->debugSelectedElementId == currentElement->id) {
                 layoutData.selectedElementRowIndex = layoutData.rowCount;
@@ -3236,7 +4451,7 @@ Clay__RenderDebugLayoutData Clay__RenderDebugLayoutElementsList(int32_t initialR
                         .cornerRadius = CLAY_CORNER_RADIUS(4),
                         .border = { .color = CLAY__DEBUGVIEW_COLOR_3, .width = {1, 1, 1, 1, 0} },
                     }) {
-                        CLAY_TEXT((currentElementData && currentElementData->debugData->collapsed) ? CLAY_STRING("+") : CLAY_STRING("-"), CLAY_TEXT_CONFIG({ .textColor = CLAY__DEBUGVIEW_COLOR_4, .fontSize = 16 }));
+                        CLAY_TEXT(currentElementColdData->debugData.collapsed ? CLAY_STRING("+") : CLAY_STRING("-"), CLAY_TEXT_CONFIG({ .textColor = CLAY__DEBUGVIEW_COLOR_4, .fontSize = 16 }));
                     }
                 } else { // Square dot for empty containers
                     CLAY_AUTO_ID({ .layout = { .sizing = {CLAY_SIZING_FIXED(16), CLAY_SIZING_FIXED(16)}, .childAlignment = { CLAY_ALIGN_X_CENTER, CLAY_ALIGN_Y_CENTER } } }) {
@@ -3245,7 +4460,7 @@ Clay__RenderDebugLayoutData Clay__RenderDebugLayoutElementsList(int32_t initialR
                 }
                 // Collisions and offscreen info
                 if (currentElementData) {
-                    if (currentElementData->debugData->collision) {
+                    if (currentElementColdData->debugData.collision) {
                         CLAY_AUTO_ID({ .layout = { .padding = { 8, 8, 2, 2 }}, .border = { .color = {177, 147, 8, 255}, .width = {1, 1, 1, 1, 0} } }) {
                             CLAY_TEXT(CLAY_STRING("Duplicate ID"), CLAY_TEXT_CONFIG({ .textColor = CLAY__DEBUGVIEW_COLOR_3, .fontSize = 16 }));
                         }
@@ -3312,7 +4527,7 @@ Clay__RenderDebugLayoutData Clay__RenderDebugLayoutElementsList(int32_t initialR
             }
 
             layoutData.rowCount++;
-            if (!(Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT) || (currentElementData && currentElementData->debugData->collapsed))) {
+            if (!(Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT) || currentElementColdData->debugData.collapsed)) {
                 for (int32_t i = currentElement->childrenOrTextContent.children.length - 1; i >= 0; --i) {
                     Clay__int32_tArray_Add(&dfsBuffer, currentElement->childrenOrTextContent.children.elements[i]);
                     context->treeNodeVisited.internalArray[dfsBuffer.length - 1] = false; // TODO needs to be ranged checked
@@ -3326,8 +4541,8 @@ Clay__RenderDebugLayoutData Clay__RenderDebugLayoutElementsList(int32_t initialR
         for (int32_t i = (int)context->pointerOverIds.length - 1; i >= 0; i--) {
             Clay_ElementId *elementId = Clay_ElementIdArray_Get(&context->pointerOverIds, i);
             if (elementId->baseId == collapseButtonId.baseId) {
-                Clay_LayoutElementHashMapItem *highlightedItem = Clay__GetHashMapItem(elementId->offset);
-                highlightedItem->debugData->collapsed = !highlightedItem->debugData->collapsed;
+                Clay__LayoutElementHashMapItemCold *highlightedItem = Clay__GetHashMapItemCold(Clay__GetHashMapItem(elementId->offset));
+                highlightedItem->debugData.collapsed = !highlightedItem->debugData.collapsed;
                 break;
             }
         }
@@ -3509,6 +4724,7 @@ void Clay__RenderDebugView(void) {
         CLAY_AUTO_ID({ .layout = { .sizing = {.width = CLAY_SIZING_GROW(0), .height = CLAY_SIZING_FIXED(1)} }, .backgroundColor = CLAY__DEBUGVIEW_COLOR_3 }) {}
         if (context->debugSelectedElementId != 0) {
             Clay_LayoutElementHashMapItem *selectedItem = Clay__GetHashMapItem(context->debugSelectedElementId);
+            Clay__LayoutElementHashMapItemCold *selectedItemCold = Clay__GetHashMapItemCold(selectedItem);
             CLAY_AUTO_ID({
                 .layout = { .sizing = {CLAY_SIZING_GROW(0), CLAY_SIZING_FIXED(300)}, .layoutDirection = CLAY_TOP_TO_BOTTOM },
                 .backgroundColor = CLAY__DEBUGVIEW_COLOR_2 ,
@@ -3518,11 +4734,11 @@ void Clay__RenderDebugView(void) {
                 CLAY_AUTO_ID({ .layout = { .sizing = {CLAY_SIZING_GROW(0), CLAY_SIZING_FIXED(CLAY__DEBUGVIEW_ROW_HEIGHT + 8)}, .padding = {CLAY__DEBUGVIEW_OUTER_PADDING, CLAY__DEBUGVIEW_OUTER_PADDING, 0, 0 }, .childAlignment = {.y = CLAY_ALIGN_Y_CENTER} } }) {
                     CLAY_TEXT(CLAY_STRING("Layout Config"), infoTextConfig);
                     CLAY_AUTO_ID({ .layout = { .sizing = { .width = CLAY_SIZING_GROW(0) } } }) {}
-                    if (selectedItem->elementId.stringId.length != 0) {
-                        CLAY_TEXT(selectedItem->elementId.stringId, infoTitleConfig);
-                        if (selectedItem->elementId.offset != 0) {
+                    if (selectedItemCold->elementId.stringId.length != 0) {
+                        CLAY_TEXT(selectedItemCold->elementId.stringId, infoTitleConfig);
+                        if (selectedItemCold->elementId.offset != 0) {
                             CLAY_TEXT(CLAY_STRING(" ("), infoTitleConfig);
-                            CLAY_TEXT(Clay__IntToString(selectedItem->elementId.offset), infoTitleConfig);
+                            CLAY_TEXT(Clay__IntToString(selectedItemCold->elementId.offset), infoTitleConfig);
                             CLAY_TEXT(CLAY_STRING(")"), infoTitleConfig);
                         }
                     }
@@ -3597,7 +4813,7 @@ void Clay__RenderDebugView(void) {
                 }
                 for (int32_t elementConfigIndex = 0; elementConfigIndex < selectedItem->layoutElement->elementConfigs.length; ++elementConfigIndex) {
                     Clay_ElementConfig *elementConfig = Clay__ElementConfigArraySlice_Get(&selectedItem->layoutElement->elementConfigs, elementConfigIndex);
-                    Clay__RenderDebugViewElementConfigHeader(selectedItem->elementId.stringId, elementConfig->type);
+                    Clay__RenderDebugViewElementConfigHeader(selectedItemCold->elementId.stringId, elementConfig->type);
                     switch (elementConfig->type) {
                         case CLAY__ELEMENT_CONFIG_TYPE_SHARED: {
                             Clay_SharedElementConfig *sharedConfig = elementConfig->config.sharedElementConfig;
@@ -3719,7 +4935,7 @@ void Clay__RenderDebugView(void) {
                                 CLAY_TEXT(Clay__IntToString(floatingConfig->zIndex), infoTextConfig);
                                 // .parentId
                                 CLAY_TEXT(CLAY_STRING("Parent"), infoTitleConfig);
-                                Clay_LayoutElementHashMapItem *hashItem = Clay__GetHashMapItem(floatingConfig->parentId);
+                                Clay__LayoutElementHashMapItemCold *hashItem = Clay__GetHashMapItemCold(Clay__GetHashMapItem(floatingConfig->parentId));
                                 CLAY_TEXT(hashItem->elementId.stringId, infoTextConfig);
                                 // .attachPoints
                                 CLAY_TEXT(CLAY_STRING("Attach Points"), infoTitleConfig);
@@ -3954,6 +5170,13 @@ void Clay_SetMeasureTextFunction(Clay_Dimensions (*measureTextFunction)(Clay_Str
     Clay__MeasureText = measureTextFunction;
     context->measureTextUserData = userData;
 }
+
+void Clay_SetParallelForFunction(void (*parallelForFunction)(int32_t taskCount, void (*task)(int32_t taskIndex, void *taskData), void *taskData, void *userData), void *userData) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    context->parallelForFunction = parallelForFunction;
+    context->parallelForUserData = userData;
+}
+
 void Clay_SetQueryScrollOffsetFunction(Clay_Vector2 (*queryScrollOffsetFunction)(uint32_t elementId, void *userData), void *userData) {
     Clay_Context* context = Clay_GetCurrentContext();
     Clay__QueryScrollOffset = queryScrollOffsetFunction;
@@ -3966,13 +5189,9 @@ void Clay_SetLayoutDimensions(Clay_Dimensions dimensions) {
     Clay_GetCurrentContext()->layoutDimensions = dimensions;
 }
 
-CLAY_WASM_EXPORT("Clay_SetPointerState")
-void Clay_SetPointerState(Clay_Vector2 position, bool isPointerDown) {
+// Walks every element of the last layout, used while a layout is in progress and there is no pointer index to query
+void Clay__UpdatePointerOverIdsLinear(Clay_Vector2 position) {
     Clay_Context* context = Clay_GetCurrentContext();
-    if (context->booleanWarnings.maxElementsExceeded) {
-        return;
-    }
-    context->pointerInfo.position = position;
     context->pointerOverIds.length = 0;
     Clay__int32_tArray dfsBuffer = context->layoutElementChildrenBuffer;
     for (int32_t rootIndex = context->layoutElementTreeRoots.length - 1; rootIndex >= 0; --rootIndex) {
@@ -3996,10 +5215,11 @@ void Clay_SetPointerState(Clay_Vector2 position, bool isPointerDown) {
                 elementBox.x -= root->pointerOffset.x;
                 elementBox.y -= root->pointerOffset.y;
                 if ((Clay__PointIsInsideRect(position, elementBox)) && (clipElementId == 0 || (Clay__PointIsInsideRect(position, clipItem->boundingBox)) || context->externalScrollHandlingEnabled)) {
-                    if (mapItem->onHoverFunction) {
-                        mapItem->onHoverFunction(mapItem->elementId, context->pointerInfo, mapItem->hoverFunctionUserData);
+                    Clay__LayoutElementHashMapItemCold *coldItem = Clay__GetHashMapItemCold(mapItem);
+                    if (coldItem->onHoverFunction) {
+                        coldItem->onHoverFunction(coldItem->elementId, context->pointerInfo, coldItem->hoverFunctionUserData);
                     }
-                    Clay_ElementIdArray_Add(&context->pointerOverIds, mapItem->elementId);
+                    Clay_ElementIdArray_Add(&context->pointerOverIds, coldItem->elementId);
                     found = true;
                 }
                 if (Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT)) {
@@ -4021,6 +5241,212 @@ void Clay_SetPointerState(Clay_Vector2 position, bool isPointerDown) {
             break;
         }
     }
+}
+
+bool Clay__RootCapturesPointer(int32_t rootIndex) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, rootIndex);
+    Clay_LayoutElement *rootElement = Clay_LayoutElementArray_Get(&context->layoutElements, root->layoutElementIndex);
+    return Clay__ElementHasConfig(rootElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING) &&
+        Clay__FindElementConfigWithType(rootElement, CLAY__ELEMENT_CONFIG_TYPE_FLOATING).floatingElementConfig->pointerCaptureMode == CLAY_POINTER_CAPTURE_MODE_CAPTURE;
+}
+
+// Collects every element in reporting order, then builds a BVH over them.
+// Nodes are split at the midpoint of the longest axis of their entries' centers, or in half by count when that fails.
+void Clay__BuildPointerIndex(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay__PointerIndexEntryArray *entries = &context->pointerIndexEntries;
+    Clay__PointerIndexNodeArray *nodes = &context->pointerIndexNodes;
+    Clay__int32_tArray *order = &context->pointerIndexOrder;
+    entries->length = 0;
+    nodes->length = 0;
+    order->length = 0;
+    context->pointerIndexBuilt = true;
+
+    Clay__int32_tArray dfsBuffer = context->layoutElementChildrenBuffer;
+    for (int32_t rootIndex = context->layoutElementTreeRoots.length - 1; rootIndex >= 0; --rootIndex) {
+        dfsBuffer.length = 0;
+        Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, rootIndex);
+        Clay__int32_tArray_Add(&dfsBuffer, (int32_t)root->layoutElementIndex);
+        context->treeNodeVisited.internalArray[0] = false;
+        while (dfsBuffer.length > 0) {
+            if (context->treeNodeVisited.internalArray[dfsBuffer.length - 1]) {
+                dfsBuffer.length--;
+                continue;
+            }
+            context->treeNodeVisited.internalArray[dfsBuffer.length - 1] = true;
+            Clay_LayoutElement *currentElement = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(&dfsBuffer, (int)dfsBuffer.length - 1));
+            Clay_LayoutElementHashMapItem *mapItem = Clay__GetHashMapItem(currentElement->id);
+            int32_t clipElementId = Clay__int32_tArray_GetValue(&context->layoutElementClipElementIds, (int32_t)(currentElement - context->layoutElements.internalArray));
+            Clay_BoundingBox elementBox = mapItem->boundingBox;
+            elementBox.x -= root->pointerOffset.x;
+            elementBox.y -= root->pointerOffset.y;
+            Clay__int32_tArray_Add(order, entries->length);
+            Clay__PointerIndexEntryArray_Add(entries, CLAY__INIT(Clay__PointerIndexEntry) {
+                .boundingBox = elementBox,
+                .clipBoundingBox = clipElementId != 0 ? Clay__GetHashMapItem(clipElementId)->boundingBox : CLAY__INIT(Clay_BoundingBox) CLAY__DEFAULT_STRUCT,
+                .hashMapItem = mapItem,
+                .rootIndex = rootIndex,
+                .clipped = clipElementId != 0,
+            });
+            if (Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT)) {
+                dfsBuffer.length--;
+                continue;
+            }
+            for (int32_t i = currentElement->childrenOrTextContent.children.length - 1; i >= 0; --i) {
+                Clay__int32_tArray_Add(&dfsBuffer, currentElement->childrenOrTextContent.children.elements[i]);
+                context->treeNodeVisited.internalArray[dfsBuffer.length - 1] = false; // TODO needs to be ranged checked
+            }
+        }
+    }
+
+    if (entries->length == 0) {
+        return;
+    }
+    Clay__PointerIndexNodeArray_Add(nodes, CLAY__INIT(Clay__PointerIndexNode) { .firstIndex = 0, .count = entries->length });
+    // Nodes are processed in the order they are created, so the node array doubles as the work queue
+    for (int32_t nodeIndex = 0; nodeIndex < nodes->length; ++nodeIndex) {
+        Clay__PointerIndexNode *node = &nodes->internalArray[nodeIndex];
+        int32_t first = node->firstIndex;
+        int32_t count = node->count;
+        Clay_BoundingBox firstBox = entries->internalArray[order->internalArray[first]].boundingBox;
+        float minX = firstBox.x, minY = firstBox.y, maxX = firstBox.x + firstBox.width, maxY = firstBox.y + firstBox.height;
+        float minCenterX = firstBox.x + firstBox.width / 2, maxCenterX = minCenterX;
+        float minCenterY = firstBox.y + firstBox.height / 2, maxCenterY = minCenterY;
+        for (int32_t i = first + 1; i < first + count; ++i) {
+            Clay_BoundingBox box = entries->internalArray[order->internalArray[i]].boundingBox;
+            minX = CLAY__MIN(minX, box.x);
+            minY = CLAY__MIN(minY, box.y);
+            maxX = CLAY__MAX(maxX, box.x + box.width);
+            maxY = CLAY__MAX(maxY, box.y + box.height);
+            minCenterX = CLAY__MIN(minCenterX, box.x + box.width / 2);
+            maxCenterX = CLAY__MAX(maxCenterX, box.x + box.width / 2);
+            minCenterY = CLAY__MIN(minCenterY, box.y + box.height / 2);
+            maxCenterY = CLAY__MAX(maxCenterY, box.y + box.height / 2);
+        }
+        node->min = CLAY__INIT(Clay_Vector2) { minX, minY };
+        node->max = CLAY__INIT(Clay_Vector2) { maxX, maxY };
+        if (count <= CLAY__POINTER_INDEX_LEAF_SIZE) {
+            continue;
+        }
+
+        bool splitX = maxCenterX - minCenterX >= maxCenterY - minCenterY;
+        float splitPosition = splitX ? (minCenterX + maxCenterX) / 2 : (minCenterY + maxCenterY) / 2;
+        int32_t left = first;
+        int32_t right = first + count - 1;
+        while (left <= right) {
+            Clay_BoundingBox box = entries->internalArray[order->internalArray[left]].boundingBox;
+            float center = splitX ? box.x + box.width / 2 : box.y + box.height / 2;
+            if (center < splitPosition) {
+                left++;
+            } else {
+                int32_t swap = order->internalArray[left];
+                order->internalArray[left] = order->internalArray[right];
+                order->internalArray[right] = swap;
+                right--;
+            }
+        }
+        int32_t leftCount = left - first;
+        if (leftCount == 0 || leftCount == count) {
+            leftCount = count / 2;
+        }
+        node->firstIndex = nodes->length;
+        node->count = 0;
+        Clay__PointerIndexNodeArray_Add(nodes, CLAY__INIT(Clay__PointerIndexNode) { .firstIndex = first, .count = leftCount });
+        Clay__PointerIndexNodeArray_Add(nodes, CLAY__INIT(Clay__PointerIndexNode) { .firstIndex = first + leftCount, .count = count - leftCount });
+    }
+}
+
+// Restores the max heap property below hits[index], used to sort the hits back into reporting order
+void Clay__SiftDownPointerHit(int32_t *hits, int32_t index, int32_t length) {
+    while (true) {
+        int32_t largest = index;
+        int32_t left = index * 2 + 1;
+        int32_t right = left + 1;
+        if (left < length && hits[left] > hits[largest]) largest = left;
+        if (right < length && hits[right] > hits[largest]) largest = right;
+        if (largest == index) return;
+        int32_t swap = hits[index];
+        hits[index] = hits[largest];
+        hits[largest] = swap;
+        index = largest;
+    }
+}
+
+void Clay__UpdatePointerOverIdsIndexed(Clay_Vector2 position) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (!context->pointerIndexBuilt) {
+        Clay__BuildPointerIndex();
+    }
+    context->pointerOverIds.length = 0;
+    Clay__PointerIndexEntryArray *entries = &context->pointerIndexEntries;
+    Clay__PointerIndexNodeArray *nodes = &context->pointerIndexNodes;
+    Clay__int32_tArray *stack = &context->pointerIndexStack;
+    Clay__int32_tArray *hits = &context->pointerIndexHits;
+    hits->length = 0;
+    stack->length = 0;
+    if (nodes->length > 0) {
+        Clay__int32_tArray_Add(stack, 0);
+    }
+    while (stack->length > 0) {
+        Clay__PointerIndexNode *node = &nodes->internalArray[stack->internalArray[--stack->length]];
+        if (position.x < node->min.x || position.x > node->max.x || position.y < node->min.y || position.y > node->max.y) {
+            continue;
+        }
+        if (node->count == 0) {
+            Clay__int32_tArray_Add(stack, node->firstIndex);
+            Clay__int32_tArray_Add(stack, node->firstIndex + 1);
+            continue;
+        }
+        for (int32_t i = node->firstIndex; i < node->firstIndex + node->count; ++i) {
+            int32_t entryIndex = context->pointerIndexOrder.internalArray[i];
+            Clay__PointerIndexEntry *entry = &entries->internalArray[entryIndex];
+            if (Clay__PointIsInsideRect(position, entry->boundingBox) && (!entry->clipped || Clay__PointIsInsideRect(position, entry->clipBoundingBox) || context->externalScrollHandlingEnabled)) {
+                Clay__int32_tArray_Add(hits, entryIndex);
+            }
+        }
+    }
+
+    // Entries were collected in reporting order, so sorting the hits by entry index restores it
+    for (int32_t i = hits->length / 2 - 1; i >= 0; --i) {
+        Clay__SiftDownPointerHit(hits->internalArray, i, hits->length);
+    }
+    for (int32_t end = hits->length - 1; end > 0; --end) {
+        int32_t swap = hits->internalArray[0];
+        hits->internalArray[0] = hits->internalArray[end];
+        hits->internalArray[end] = swap;
+        Clay__SiftDownPointerHit(hits->internalArray, 0, end);
+    }
+
+    for (int32_t i = 0; i < hits->length; ++i) {
+        Clay__PointerIndexEntry *entry = &entries->internalArray[hits->internalArray[i]];
+        // A root that captures the pointer hides every root below it
+        if (i > 0) {
+            int32_t previousRootIndex = entries->internalArray[hits->internalArray[i - 1]].rootIndex;
+            if (previousRootIndex != entry->rootIndex && Clay__RootCapturesPointer(previousRootIndex)) {
+                break;
+            }
+        }
+        Clay__LayoutElementHashMapItemCold *coldItem = Clay__GetHashMapItemCold(entry->hashMapItem);
+        if (coldItem->onHoverFunction) {
+            coldItem->onHoverFunction(coldItem->elementId, context->pointerInfo, coldItem->hoverFunctionUserData);
+        }
+        Clay_ElementIdArray_Add(&context->pointerOverIds, coldItem->elementId);
+    }
+}
+
+CLAY_WASM_EXPORT("Clay_SetPointerState")
+void Clay_SetPointerState(Clay_Vector2 position, bool isPointerDown) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context->booleanWarnings.maxElementsExceeded) {
+        return;
+    }
+    context->pointerInfo.position = position;
+    if (context->pointerIndexAvailable) {
+        Clay__UpdatePointerOverIdsIndexed(position);
+    } else {
+        Clay__UpdatePointerOverIdsLinear(position);
+    }
 
     if (isPointerDown) {
         if (context->pointerInfo.state == CLAY_POINTER_DATA_PRESSED_THIS_FRAME) {
@@ -4050,6 +5476,7 @@ Clay_Context* Clay_Initialize(Clay_Arena arena, Clay_Dimensions layoutDimensions
     *context = CLAY__INIT(Clay_Context) {
         .maxElementCount = oldContext ? oldContext->maxElementCount : Clay__defaultMaxElementCount,
         .maxMeasureTextCacheWordCount = oldContext ? oldContext->maxMeasureTextCacheWordCount : Clay__defaultMaxMeasureTextWordCacheCount,
+        .measureTextCachePolicy = oldContext ? oldContext->measureTextCachePolicy : CLAY__INIT(Clay_MeasureTextCachePolicy) { .maxUnusedFrames = 2 },
         .errorHandler = errorHandler.errorHandlerFunction ? errorHandler : CLAY__INIT(Clay_ErrorHandler) { Clay__ErrorHandlerFunctionDefault, 0 },
         .layoutDimensions = layoutDimensions,
         .internalArena = arena,
@@ -4058,12 +5485,13 @@ Clay_Context* Clay_Initialize(Clay_Arena arena, Clay_Dimensions layoutDimensions
     Clay__InitializePersistentMemory(context);
     Clay__InitializeEphemeralMemory(context);
     for (int32_t i = 0; i < context->layoutElementsHashMap.capacity; ++i) {
-        context->layoutElementsHashMap.internalArray[i] = -1;
+        context->layoutElementsHashMap.internalArray[i] = CLAY__INIT(Clay__LayoutElementHashMapSlot) CLAY__DEFAULT_STRUCT;
     }
     for (int32_t i = 0; i < context->measureTextHashMap.capacity; ++i) {
         context->measureTextHashMap.internalArray[i] = 0;
     }
     context->measureTextHashMapInternal.length = 1; // Reserve the 0 value to mean "no next element"
+    Clay__ResetMeasureTextCacheLru();
     context->layoutDimensions = layoutDimensions;
     return context;
 }
@@ -4215,7 +5643,12 @@ void Clay_UpdateScrollContainers(bool enableDragScrolling, Clay_Vector2 scrollDe
 CLAY_WASM_EXPORT("Clay_BeginLayout")
 void Clay_BeginLayout(void) {
     Clay_Context* context = Clay_GetCurrentContext();
+    if (context->growAllocateFunction) {
+        Clay__GrowContextIfNeeded();
+    }
     Clay__InitializeEphemeralMemory(context);
+    context->pointerIndexAvailable = false;
+    context->pointerIndexBuilt = false;
     context->generation++;
     context->dynamicElementIndex = 0;
     // Set up the root container that covers the entire window
@@ -4232,6 +5665,16 @@ void Clay_BeginLayout(void) {
     Clay__LayoutElementTreeRootArray_Add(&context->layoutElementTreeRoots, CLAY__INIT(Clay__LayoutElementTreeRoot) { .layoutElementIndex = 0 });
 }
 
+// Order matters, Clay_PointerOver and the hover callbacks report the same elements in the same order
+uint32_t Clay__HashPointerOverIds(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    uint32_t hash = 2166136261u;
+    for (int32_t i = 0; i < context->pointerOverIds.length; ++i) {
+        hash = (hash ^ context->pointerOverIds.internalArray[i].id) * 16777619u;
+    }
+    return (hash ^ (uint32_t)context->pointerOverIds.length) * 16777619u;
+}
+
 CLAY_WASM_EXPORT("Clay_EndLayout")
 Clay_RenderCommandArray Clay_EndLayout(void) {
     Clay_Context* context = Clay_GetCurrentContext();
@@ -4261,10 +5704,289 @@ Clay_RenderCommandArray Clay_EndLayout(void) {
                 .errorText = CLAY_STRING("There were still open layout elements when EndLayout was called. This results from an unequal number of calls to Clay__OpenElement and Clay__CloseElement."),
                 .userData = context->errorHandler.userData });
     }
-    Clay__CalculateFinalLayout();
+    // Elements and configs past the capacity were dropped, the tree can't be laid out, only the error message is drawn
+    if (!context->booleanWarnings.maxElementsExceeded) {
+        Clay__CalculateFinalLayout();
+    }
+    context->pointerIndexAvailable = true;
+    context->lastLayoutValid = true;
+    context->lastLayoutDimensions = context->layoutDimensions;
+    context->lastLayoutPointerOverHash = Clay__HashPointerOverIds();
+    context->lastLayoutDebugModeEnabled = context->debugModeEnabled;
+    for (int32_t i = 0; i < context->scrollContainerDatas.length; i++) {
+        Clay__ScrollContainerDataInternal *scrollData = Clay__ScrollContainerDataInternalArray_Get(&context->scrollContainerDatas, i);
+        scrollData->layoutScrollPosition = scrollData->scrollPosition;
+    }
     return context->renderCommands;
 }
 
+CLAY_WASM_EXPORT("Clay_IsAnimating")
+bool Clay_IsAnimating(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    for (int32_t i = 0; i < context->scrollContainerDatas.length; i++) {
+        Clay__ScrollContainerDataInternal *scrollData = Clay__ScrollContainerDataInternalArray_Get(&context->scrollContainerDatas, i);
+        // Clay_UpdateScrollContainers zeroes momentum once it falls under a tenth of a pixel
+        if (scrollData->scrollMomentum.x != 0 || scrollData->scrollMomentum.y != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+CLAY_WASM_EXPORT("Clay_NeedsLayout")
+bool Clay_NeedsLayout(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (!context->lastLayoutValid || context->booleanWarnings.maxElementsExceeded) {
+        return true;
+    }
+    if (context->layoutDimensions.width != context->lastLayoutDimensions.width || context->layoutDimensions.height != context->lastLayoutDimensions.height) {
+        return true;
+    }
+    if (context->debugModeEnabled != context->lastLayoutDebugModeEnabled) {
+        return true;
+    }
+    // Presses and releases are only visible to the layout for the frame they happen in
+    if (context->pointerInfo.state == CLAY_POINTER_DATA_PRESSED_THIS_FRAME || context->pointerInfo.state == CLAY_POINTER_DATA_RELEASED_THIS_FRAME) {
+        return true;
+    }
+    if (Clay__HashPointerOverIds() != context->lastLayoutPointerOverHash) {
+        return true;
+    }
+    for (int32_t i = 0; i < context->scrollContainerDatas.length; i++) {
+        Clay__ScrollContainerDataInternal *scrollData = Clay__ScrollContainerDataInternalArray_Get(&context->scrollContainerDatas, i);
+        if (scrollData->scrollMomentum.x != 0 || scrollData->scrollMomentum.y != 0 ||
+            scrollData->scrollPosition.x != scrollData->layoutScrollPosition.x || scrollData->scrollPosition.y != scrollData->layoutScrollPosition.y) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t Clay__HashLayoutColor(uint32_t hash, Clay_Color color) {
+    hash = Clay__HashLayoutFloat(hash, color.r);
+    hash = Clay__HashLayoutFloat(hash, color.g);
+    hash = Clay__HashLayoutFloat(hash, color.b);
+    return Clay__HashLayoutFloat(hash, color.a);
+}
+
+uint32_t Clay__HashLayoutCornerRadius(uint32_t hash, Clay_CornerRadius cornerRadius) {
+    hash = Clay__HashLayoutFloat(hash, cornerRadius.topLeft);
+    hash = Clay__HashLayoutFloat(hash, cornerRadius.topRight);
+    hash = Clay__HashLayoutFloat(hash, cornerRadius.bottomLeft);
+    return Clay__HashLayoutFloat(hash, cornerRadius.bottomRight);
+}
+
+// Hashes everything a renderer may draw for a command apart from its bounding box
+uint32_t Clay__HashRenderCommandContents(Clay_RenderCommand *renderCommand) {
+    uint32_t hash = Clay__HashLayoutValue(0, (uint32_t)renderCommand->zIndex);
+    hash = Clay__HashLayoutValue(hash, (uint32_t)(uintptr_t)renderCommand->userData);
+    switch (renderCommand->commandType) {
+        case CLAY_RENDER_COMMAND_TYPE_RECTANGLE: {
+            Clay_RectangleRenderData *rectangle = &renderCommand->renderData.rectangle;
+            hash = Clay__HashLayoutColor(hash, rectangle->backgroundColor);
+            hash = Clay__HashLayoutCornerRadius(hash, rectangle->cornerRadius);
+            break;
+        }
+        case CLAY_RENDER_COMMAND_TYPE_BORDER: {
+            Clay_BorderRenderData *border = &renderCommand->renderData.border;
+            hash = Clay__HashLayoutColor(hash, border->color);
+            hash = Clay__HashLayoutCornerRadius(hash, border->cornerRadius);
+            hash = Clay__HashLayoutValue(hash, (uint32_t)border->width.left | ((uint32_t)border->width.right << 16));
+            hash = Clay__HashLayoutValue(hash, (uint32_t)border->width.top | ((uint32_t)border->width.bottom << 16));
+            hash = Clay__HashLayoutValue(hash, border->width.betweenChildren);
+            break;
+        }
+        case CLAY_RENDER_COMMAND_TYPE_TEXT: {
+            Clay_TextRenderData *text = &renderCommand->renderData.text;
+            // The characters are hashed rather than the pointer, dynamic strings are often rebuilt in the same buffer every frame
+            hash = Clay__HashLayoutValue(hash, (uint32_t)(Clay__HashData((const uint8_t *)text->stringContents.chars, text->stringContents.length) % UINT32_MAX));
+            hash = Clay__HashLayoutValue(hash, (uint32_t)text->stringContents.length);
+            hash = Clay__HashLayoutColor(hash, text->textColor);
+            hash = Clay__HashLayoutValue(hash, (uint32_t)text->fontId | ((uint32_t)text->fontSize << 16));
+            hash = Clay__HashLayoutValue(hash, (uint32_t)text->letterSpacing | ((uint32_t)text->lineHeight << 16));
+            break;
+        }
+        case CLAY_RENDER_COMMAND_TYPE_IMAGE: {
+            Clay_ImageRenderData *image = &renderCommand->renderData.image;
+            hash = Clay__HashLayoutColor(hash, image->backgroundColor);
+            hash = Clay__HashLayoutCornerRadius(hash, image->cornerRadius);
+            hash = Clay__HashLayoutValue(hash, (uint32_t)(uintptr_t)image->imageData);
+            break;
+        }
+        case CLAY_RENDER_COMMAND_TYPE_CUSTOM: {
+            Clay_CustomRenderData *custom = &renderCommand->renderData.custom;
+            hash = Clay__HashLayoutColor(hash, custom->backgroundColor);
+            hash = Clay__HashLayoutCornerRadius(hash, custom->cornerRadius);
+            hash = Clay__HashLayoutValue(hash, (uint32_t)(uintptr_t)custom->customData);
+            break;
+        }
+        case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START:
+        case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END: {
+            Clay_ClipRenderData *clip = &renderCommand->renderData.clip;
+            hash = Clay__HashLayoutValue(hash, (uint32_t)clip->horizontal | ((uint32_t)clip->vertical << 1));
+            break;
+        }
+        default: break;
+    }
+    return hash;
+}
+
+uint32_t Clay__RenderCommandSnapshotSlot(uint32_t id, Clay_RenderCommandType commandType, int32_t capacity) {
+    return Clay__HashLayoutFinalize(Clay__HashLayoutValue(Clay__HashLayoutValue(0, id), commandType)) % (uint32_t)capacity;
+}
+
+bool Clay__BoundingBoxEqual(Clay_BoundingBox a, Clay_BoundingBox b) {
+    return a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height;
+}
+
+Clay_BoundingBox Clay__BoundingBoxUnion(Clay_BoundingBox a, Clay_BoundingBox b) {
+    float minX = CLAY__MIN(a.x, b.x);
+    float minY = CLAY__MIN(a.y, b.y);
+    float maxX = CLAY__MAX(a.x + a.width, b.x + b.width);
+    float maxY = CLAY__MAX(a.y + a.height, b.y + b.height);
+    return CLAY__INIT(Clay_BoundingBox) { minX, minY, maxX - minX, maxY - minY };
+}
+
+bool Clay__BoundingBoxesOverlap(Clay_BoundingBox a, Clay_BoundingBox b) {
+    return a.x <= b.x + b.width && b.x <= a.x + a.width && a.y <= b.y + b.height && b.y <= a.y + a.height;
+}
+
+// Adds a region to the damage list, merging it with any rect it touches so the list stays non overlapping.
+// Once the list is full the region is folded into whichever rect grows the least.
+void Clay__AddDamageRect(Clay_BoundingBox rect) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay_BoundingBoxArray *damageRects = &context->damageRects;
+    float maxX = CLAY__MIN(rect.x + rect.width, context->layoutDimensions.width);
+    float maxY = CLAY__MIN(rect.y + rect.height, context->layoutDimensions.height);
+    rect.x = CLAY__MAX(rect.x, 0);
+    rect.y = CLAY__MAX(rect.y, 0);
+    rect.width = maxX - rect.x;
+    rect.height = maxY - rect.y;
+    if (rect.width <= 0 || rect.height <= 0) {
+        return;
+    }
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (int32_t i = 0; i < damageRects->length; ++i) {
+            if (Clay__BoundingBoxesOverlap(rect, damageRects->internalArray[i])) {
+                rect = Clay__BoundingBoxUnion(rect, damageRects->internalArray[i]);
+                damageRects->internalArray[i] = damageRects->internalArray[--damageRects->length];
+                merged = true;
+                break;
+            }
+        }
+        if (!merged && damageRects->length == damageRects->capacity) {
+            int32_t bestIndex = 0;
+            float bestGrowth = 0;
+            for (int32_t i = 0; i < damageRects->length; ++i) {
+                Clay_BoundingBox existing = damageRects->internalArray[i];
+                Clay_BoundingBox combined = Clay__BoundingBoxUnion(rect, existing);
+                float growth = combined.width * combined.height - existing.width * existing.height;
+                if (i == 0 || growth < bestGrowth) {
+                    bestIndex = i;
+                    bestGrowth = growth;
+                }
+            }
+            rect = Clay__BoundingBoxUnion(rect, damageRects->internalArray[bestIndex]);
+            damageRects->internalArray[bestIndex] = damageRects->internalArray[--damageRects->length];
+            merged = true;
+        }
+    }
+    Clay_BoundingBoxArray_Add(damageRects, rect);
+}
+
+CLAY_WASM_EXPORT("Clay_EndLayoutDiff")
+Clay_LayoutDiff Clay_EndLayoutDiff(void) {
+    Clay_RenderCommandArray renderCommands = Clay_EndLayout();
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay__RenderCommandSnapshotArray previous = context->renderCommandSnapshots;
+    Clay__RenderCommandSnapshotArray *current = &context->renderCommandSnapshots;
+    context->renderCommandSnapshots = context->previousRenderCommandSnapshots;
+    context->previousRenderCommandSnapshots = previous;
+    current->length = 0;
+
+    Clay__int32_tArray *lookup = &context->renderCommandSnapshotLookup;
+    lookup->length = lookup->capacity; // This array is accessed directly rather than behaving as a list
+    for (int32_t i = 0; i < lookup->capacity; ++i) {
+        lookup->internalArray[i] = -1;
+    }
+    for (int32_t i = 0; i < previous.length; ++i) {
+        Clay__RenderCommandSnapshot *snapshot = &previous.internalArray[i];
+        snapshot->matched = false;
+        uint32_t slot = Clay__RenderCommandSnapshotSlot(snapshot->id, snapshot->commandType, lookup->capacity);
+        while (lookup->internalArray[slot] != -1) {
+            slot = (slot + 1) % (uint32_t)lookup->capacity;
+        }
+        lookup->internalArray[slot] = i;
+    }
+
+    for (int32_t i = 0; i < renderCommands.length; ++i) {
+        Clay_RenderCommand *renderCommand = &renderCommands.internalArray[i];
+        Clay__RenderCommandSnapshot snapshot = {
+            .boundingBox = renderCommand->boundingBox,
+            .id = renderCommand->id,
+            .contentHash = Clay__HashRenderCommandContents(renderCommand),
+            .commandType = renderCommand->commandType
+        };
+        Clay__RenderCommandSnapshotArray_Add(current, snapshot);
+
+        Clay__RenderCommandSnapshot *match = NULL;
+        uint32_t slot = Clay__RenderCommandSnapshotSlot(snapshot.id, snapshot.commandType, lookup->capacity);
+        while (lookup->internalArray[slot] != -1) {
+            Clay__RenderCommandSnapshot *candidate = &previous.internalArray[lookup->internalArray[slot]];
+            // Duplicate ids are matched in order, any leftovers are reported as removed
+            if (!candidate->matched && candidate->id == snapshot.id && candidate->commandType == snapshot.commandType) {
+                match = candidate;
+                break;
+            }
+            slot = (slot + 1) % (uint32_t)lookup->capacity;
+        }
+
+        if (!match) {
+            Clay_RenderCommandDiffArray_Add(&context->renderCommandDiffs, CLAY__INIT(Clay_RenderCommandDiff) {
+                .id = snapshot.id, .commandType = snapshot.commandType, .diffType = CLAY_RENDER_COMMAND_DIFF_TYPE_ADDED, .renderCommandIndex = i });
+            Clay__AddDamageRect(snapshot.boundingBox);
+            continue;
+        }
+        match->matched = true;
+        if (!Clay__BoundingBoxEqual(match->boundingBox, snapshot.boundingBox) || match->contentHash != snapshot.contentHash) {
+            Clay_RenderCommandDiffArray_Add(&context->renderCommandDiffs, CLAY__INIT(Clay_RenderCommandDiff) {
+                .id = snapshot.id, .commandType = snapshot.commandType, .diffType = CLAY_RENDER_COMMAND_DIFF_TYPE_CHANGED, .renderCommandIndex = i, .previousBoundingBox = match->boundingBox });
+            Clay__AddDamageRect(match->boundingBox);
+            Clay__AddDamageRect(snapshot.boundingBox);
+        }
+    }
+
+    for (int32_t i = 0; i < previous.length; ++i) {
+        Clay__RenderCommandSnapshot *snapshot = &previous.internalArray[i];
+        if (!snapshot->matched) {
+            Clay_RenderCommandDiffArray_Add(&context->renderCommandDiffs, CLAY__INIT(Clay_RenderCommandDiff) {
+                .id = snapshot->id, .commandType = snapshot->commandType, .diffType = CLAY_RENDER_COMMAND_DIFF_TYPE_REMOVED, .renderCommandIndex = -1, .previousBoundingBox = snapshot->boundingBox });
+            Clay__AddDamageRect(snapshot->boundingBox);
+        }
+    }
+
+    bool fullRedraw = !context->renderCommandSnapshotsValid
+        || context->renderCommandSnapshotDimensions.width != context->layoutDimensions.width
+        || context->renderCommandSnapshotDimensions.height != context->layoutDimensions.height
+        || context->booleanWarnings.maxRenderCommandsExceeded
+        || context->booleanWarnings.maxElementsExceeded;
+    if (fullRedraw) {
+        context->damageRects.length = 0;
+        Clay_BoundingBoxArray_Add(&context->damageRects, CLAY__INIT(Clay_BoundingBox) { 0, 0, context->layoutDimensions.width, context->layoutDimensions.height });
+    }
+    context->renderCommandSnapshotsValid = true;
+    context->renderCommandSnapshotDimensions = context->layoutDimensions;
+
+    return CLAY__INIT(Clay_LayoutDiff) {
+        .renderCommands = renderCommands,
+        .changes = context->renderCommandDiffs,
+        .damageRects = context->damageRects,
+        .fullRedraw = fullRedraw
+    };
+}
+
 CLAY_WASM_EXPORT("Clay_GetElementId")
 Clay_ElementId Clay_GetElementId(Clay_String idString) {
     return Clay__HashString(idString, 0);
@@ -4302,7 +6024,7 @@ void Clay_OnHover(void (*onHoverFunction)(Clay_ElementId elementId, Clay_Pointer
     if (openLayoutElement->id == 0) {
         Clay__GenerateIdForAnonymousElement(openLayoutElement);
     }
-    Clay_LayoutElementHashMapItem *hashMapItem = Clay__GetHashMapItem(openLayoutElement->id);
+    Clay__LayoutElementHashMapItemCold *hashMapItem = Clay__GetHashMapItemCold(Clay__GetHashMapItem(openLayoutElement->id));
     hashMapItem->onHoverFunction = onHoverFunction;
     hashMapItem->hoverFunctionUserData = userData;
 }
@@ -4377,6 +6099,12 @@ void Clay_SetExternalScrollHandlingEnabled(bool enabled) {
     context->externalScrollHandlingEnabled = enabled;
 }
 
+CLAY_WASM_EXPORT("Clay_SetIncrementalLayoutEnabled")
+void Clay_SetIncrementalLayoutEnabled(bool enabled) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    context->incrementalLayoutEnabled = enabled;
+}
+
 CLAY_WASM_EXPORT("Clay_GetMaxElementCount")
 int32_t Clay_GetMaxElementCount(void) {
     Clay_Context* context = Clay_GetCurrentContext();
@@ -4394,6 +6122,21 @@ void Clay_SetMaxElementCount(int32_t maxElementCount) {
     }
 }
 
+void Clay_SetGrowFunctions(void *(*allocateFunction)(size_t size, void *userData), void (*freeFunction)(void *memory, void *userData), void *userData) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    context->growAllocateFunction = allocateFunction;
+    context->growFreeFunction = freeFunction;
+    context->growUserData = userData;
+}
+
+void Clay_FreeGrownMemory(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context && context->grownMemory) {
+        context->growFreeFunction(context->grownMemory, context->growUserData);
+        context->grownMemory = NULL;
+    }
+}
+
 CLAY_WASM_EXPORT("Clay_GetMaxMeasureTextCacheWordCount")
 int32_t Clay_GetMaxMeasureTextCacheWordCount(void) {
     Clay_Context* context = Clay_GetCurrentContext();
@@ -4423,6 +6166,32 @@ void Clay_ResetMeasureTextCache(void) {
         context->measureTextHashMap.internalArray[i] = 0;
     }
     context->measureTextHashMapInternal.length = 1; // Reserve the 0 value to mean "no next element"
+    Clay__ResetMeasureTextCacheLru();
+    // Cached layout sizes were derived from the old measurements
+    for (int32_t i = 0; i < context->layoutElementsHashMapInternal.length; ++i) {
+        context->layoutElementsHashMapInternal.internalArray[i].layoutHash = 0;
+    }
+}
+
+CLAY_WASM_EXPORT("Clay_SetMeasureTextCachePolicy")
+void Clay_SetMeasureTextCachePolicy(Clay_MeasureTextCachePolicy policy) {
+    Clay_GetCurrentContext()->measureTextCachePolicy = policy;
+}
+
+CLAY_WASM_EXPORT("Clay_GetMeasureTextCacheStats")
+Clay_MeasureTextCacheStats Clay_GetMeasureTextCacheStats(void) {
+    Clay_MeasureTextCacheStats stats = Clay_GetCurrentContext()->measureTextCacheStats;
+    stats.bytesUsed = Clay__MeasureTextCacheBytesUsed();
+    return stats;
+}
+
+CLAY_WASM_EXPORT("Clay_ResetMeasureTextCacheStats")
+void Clay_ResetMeasureTextCacheStats(void) {
+    Clay_MeasureTextCacheStats *stats = &Clay_GetCurrentContext()->measureTextCacheStats;
+    stats->hits = 0;
+    stats->misses = 0;
+    stats->measureTextCalls = 0;
+    stats->evictions = 0;
 }
 
 #endif // CLAY_IMPLEMENTATION
@@ -1,5 +1,7 @@
 #include "ResourcesLoad.h"
 
+#include "renderer/raylib/clayray.h"
+
 static Texture2D gProfilePicture;
 static Font gFonts[2] = {0};
 
@@ -9,6 +11,7 @@ Font* getFonts() {
 		SetTextureFilter(gFonts[FONT_ID_BODY_24].texture, TEXTURE_FILTER_BILINEAR);
 		gFonts[FONT_ID_BODY_16] = LoadFontEx("resources/Roboto-Regular.ttf", 32, NULL, 400);
 		SetTextureFilter(gFonts[FONT_ID_BODY_16].texture, TEXTURE_FILTER_BILINEAR);
+		ClayRay_LoadFontMetrics(gFonts, 2);
 	}
 	return gFonts;
 }
@@ -14,21 +14,28 @@
 #include "components/Sidebar.h"
 
 static bool gDebugEnabled = true;
-static bool gReinitializeClay = false;
+static bool gPartialRedrawEnabled = false;
+// Skips frames Clay_NeedsLayout has nothing for and blocks on input events instead, so an idle window doesn't use the CPU
+static bool gOnDemandEnabled = true;
+// Set for changes Clay can't see, the next frame is laid out and drawn even without input
+static bool gRedrawRequested = true;
 
+// Capacity errors are recovered by Clay itself on the next frame, through the grow functions
 void HandleClayErrors(const Clay_ErrorData errorData) {
 	printf("%s", errorData.errorText.chars);
-	if (errorData.errorType == CLAY_ERROR_TYPE_ELEMENTS_CAPACITY_EXCEEDED) {
-		gReinitializeClay = true;
-		Clay_SetMaxElementCount(Clay_GetMaxElementCount() * 2);
-	}
-	else if (errorData.errorType == CLAY_ERROR_TYPE_TEXT_MEASUREMENT_CAPACITY_EXCEEDED) {
-		gReinitializeClay = true;
-		Clay_SetMaxMeasureTextCacheWordCount(Clay_GetMaxMeasureTextCacheWordCount() * 2);
-	}
 }
 
-Clay_RenderCommandArray CreateLayout(void) {
+static void* PRIV_ClayGrowAllocate(size_t size, void* userData) {
+	(void)userData;
+	return BC_Malloc(size);
+}
+
+static void PRIV_ClayGrowFree(void* memory, void* userData) {
+	(void)userData;
+	BC_Free(memory);
+}
+
+Clay_LayoutDiff CreateLayout(void) {
 	Clay_BeginLayout();
 	CLAY(CLAY_ID("OuterContainer"), {
 		.layout = { .sizing = { .width = CLAY_SIZING_GROW(0), .height = CLAY_SIZING_GROW(0) }, .padding = { 16, 16, 16, 16 }, .childGap = 16 },
@@ -39,7 +46,7 @@ Clay_RenderCommandArray CreateLayout(void) {
 		Blob4Floating2Render();
 		ScrollBarRender();
 	}
-	return Clay_EndLayout();
+	return Clay_EndLayoutDiff();
 }
 
 void UpdateDrawFrame(const Font* fonts) {
@@ -51,6 +58,14 @@ void UpdateDrawFrame(const Font* fonts) {
 		gDebugEnabled = !gDebugEnabled;
 		Clay_SetDebugModeEnabled(gDebugEnabled);
 	}
+	if (IsKeyPressed(KEY_P)) {
+		gPartialRedrawEnabled = !gPartialRedrawEnabled;
+		gRedrawRequested = true;
+	}
+	if (IsKeyPressed(KEY_O)) {
+		gOnDemandEnabled = !gOnDemandEnabled;
+		gRedrawRequested = true;
+	}
 	//----------------------------------------------------------------------------------
 	// Handle scroll containers
 	const Clay_Vector2 mousePosition = RAY_VECTOR2_TO_CLAY(GetMousePosition());
@@ -84,10 +99,25 @@ void UpdateDrawFrame(const Font* fonts) {
 
 	Clay_UpdateScrollContainers(true, (Clay_Vector2){mouseWheelX, mouseWheelY}, GetFrameTime());
 
-	const Clay_RenderCommandArray renderCommands = CreateLayout();
+	// Nothing Clay or the application knows about changed, the last frame is still on screen. Block until the next input.
+	if (gOnDemandEnabled && !gRedrawRequested && !Clay_NeedsLayout()) {
+		EnableEventWaiting();
+		PollInputEvents();
+		return;
+	}
+	DisableEventWaiting();
+
+	const Clay_LayoutDiff layoutDiff = CreateLayout();
+	// Application state changed while declaring the layout, e.g. by a click handler, only shows up in the next one
+	gRedrawRequested = layoutDiff.fullRedraw || layoutDiff.damageRects.length > 0;
 	BeginDrawing();
-	ClearBackground(BLACK);
-	ClayRay_Render(renderCommands, fonts);
+	if (gPartialRedrawEnabled) {
+		ClayRay_RenderDiff(layoutDiff, fonts, BLACK);
+	}
+	else {
+		ClearBackground(BLACK);
+		ClayRay_Render(layoutDiff.renderCommands, fonts);
+	}
 	EndDrawing();
 }
 
@@ -98,6 +128,8 @@ int BF_Main(void) {
 	uint64_t vClayMinSize = Clay_MinMemorySize();
 	Clay_Arena vClayMemory = Clay_CreateArenaWithCapacityAndMemory(vClayMinSize, BC_Malloc(vClayMinSize));
 	Clay_Initialize(vClayMemory, (Clay_Dimensions){(float)GetScreenWidth(), (float)GetScreenHeight()}, (Clay_ErrorHandler){HandleClayErrors, 0});
+	Clay_SetIncrementalLayoutEnabled(true);
+	Clay_SetGrowFunctions(PRIV_ClayGrowAllocate, PRIV_ClayGrowFree, NULL);
 
 	// ==================================
 	// Raylib Initialization
@@ -112,19 +144,13 @@ int BF_Main(void) {
 	// ==================================
 	// Main loop
 	while (!WindowShouldClose()) {
-		if (gReinitializeClay) {
-			Clay_SetMaxElementCount(8192);
-			vClayMinSize = Clay_MinMemorySize();
-			vClayMemory = Clay_CreateArenaWithCapacityAndMemory(vClayMinSize, BC_Malloc(vClayMinSize));
-			Clay_Initialize(vClayMemory, (Clay_Dimensions){(float)GetScreenWidth(), (float)GetScreenHeight()}, (Clay_ErrorHandler){HandleClayErrors, 0});
-			gReinitializeClay = false;
-		}
 		UpdateDrawFrame(getFonts());
 	}
 
 	// ==================================
 	// Cleanup
 	unloadResources();
+	Clay_FreeGrownMemory();
 	BC_Free(vClayMemory.memory);
 	ClayRay_Cleanup();
 
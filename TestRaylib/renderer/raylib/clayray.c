@@ -1,15 +1,35 @@
 #include "clayray.h"
 
 #include "raymath.h"
+#include "rlgl.h"
 
 #include "stdio.h"
 #include "stdlib.h"
 #include "string.h"
 #include "BCore/Memory/BC_Memory.h"
 
+// Vertices handed to rlgl per rlBegin/rlEnd, a multiple of 3 well under its default batch size
+#define CLAYRAY_BATCH_SUBMIT_VERTICES (3 * 1024)
+
 static Camera Raylib_camera;
 static char* temp_render_buffer = NULL;
 static int temp_render_buffer_len = 0;
+static RenderTexture2D retained_target = {0};
+static bool retained_target_valid = false;
+static ClayRayBatch render_batch = {0};
+static ClayRayBatchStats frame_batch_stats = {0};
+
+// Glyph advances of one font in font units, ASCII is indexed directly and other codepoints through a sorted sparse table
+typedef struct PRIV_FontMetrics {
+	float asciiAdvance[128];
+	int* codepoints;
+	float* codepointAdvance;
+	int codepointCount;
+	float fallbackAdvance;
+} PRIV_FontMetrics;
+
+static PRIV_FontMetrics* font_metrics = NULL;
+static int font_metrics_count = 0;
 
 // ==========================================================
 // MARK: Privates
@@ -88,10 +108,236 @@ void PRIV_CustomElementRender(const Clay_BoundingBox* rootBox, const Clay_Render
 	}
 }
 
+static void PRIV_BeginClippedScissorMode(const Clay_BoundingBox box, const Clay_BoundingBox* clip) {
+	const float minX = clip ? fmaxf(box.x, clip->x) : box.x;
+	const float minY = clip ? fmaxf(box.y, clip->y) : box.y;
+	const float maxX = clip ? fminf(box.x + box.width, clip->x + clip->width) : box.x + box.width;
+	const float maxY = clip ? fminf(box.y + box.height, clip->y + clip->height) : box.y + box.height;
+	// Rounded outwards, so fractional damage rects are cleared and redrawn up to their last partly covered pixel
+	const int x = (int)floorf(minX);
+	const int y = (int)floorf(minY);
+	BeginScissorMode(x, y, CLAY__MAX((int)ceilf(maxX) - x, 0), CLAY__MAX((int)ceilf(maxY) - y, 0));
+}
+
+// Feeds a geometry range to rlgl in one go, rlgl keeps it in a single draw until the texture, mode or scissor changes
+static void PRIV_DrawBatchGeometry(const ClayRayBatchStep* step) {
+	const ClayRayBatchVertex* vertices = &render_batch.vertices[step->firstVertex];
+	for (int first = 0; first < step->vertexCount; first += CLAYRAY_BATCH_SUBMIT_VERTICES) {
+		const int count = CLAY__MIN(CLAYRAY_BATCH_SUBMIT_VERTICES, step->vertexCount - first);
+		// Flushes the rlgl batch up front if the range doesn't fit, instead of splitting a triangle
+		rlCheckRenderBatchLimit(count);
+		rlBegin(RL_TRIANGLES);
+		for (int i = first; i < first + count; i++) {
+			rlColor4ub(vertices[i].r, vertices[i].g, vertices[i].b, vertices[i].a);
+			rlVertex2f(vertices[i].x, vertices[i].y);
+		}
+		rlEnd();
+	}
+}
+
+// Draws the commands the batch can't turn into geometry
+static void PRIV_RenderCommand(Clay_RenderCommandArray renderCommands, const Clay_RenderCommand* renderCommand, const Font* fonts, const Clay_BoundingBox* damageRect) {
+	const Clay_BoundingBox boundingBox = {
+		roundf(renderCommand->boundingBox.x),
+		roundf(renderCommand->boundingBox.y),
+		roundf(renderCommand->boundingBox.width),
+		roundf(renderCommand->boundingBox.height)
+	};
+	switch (renderCommand->commandType) {
+	case CLAY_RENDER_COMMAND_TYPE_TEXT: {
+		const Clay_TextRenderData* textData = &renderCommand->renderData.text;
+		const Font fontToUse = fonts[textData->fontId];
+
+		const int strlen = textData->stringContents.length + 1;
+
+		if (strlen > temp_render_buffer_len) {
+			// Grow the temp buffer if we need a larger string
+			if (temp_render_buffer) BC_Free(temp_render_buffer);
+			temp_render_buffer = (char*)BC_Malloc(strlen);
+			temp_render_buffer_len = strlen;
+		}
+
+		// Raylib uses standard C strings so isn't compatible with cheap slices, we need to clone the string to append null terminator
+		memcpy(temp_render_buffer, textData->stringContents.chars, textData->stringContents.length);
+		temp_render_buffer[textData->stringContents.length] = '\0';
+		DrawTextEx(
+			fontToUse,
+			temp_render_buffer,
+			(Vector2){boundingBox.x, boundingBox.y},
+			textData->fontSize, textData->letterSpacing,
+			CLAY_COLOR_TO_RAY(textData->textColor)
+		);
+
+		break;
+	}
+	case CLAY_RENDER_COMMAND_TYPE_IMAGE: {
+		const Texture2D imageTexture = *(Texture2D*)renderCommand->renderData.image.imageData;
+		Clay_Color tintColor = renderCommand->renderData.image.backgroundColor;
+		if (tintColor.r == 0 && tintColor.g == 0 && tintColor.b == 0 && tintColor.a == 0) {
+			tintColor = (Clay_Color){255, 255, 255, 255};
+		}
+		DrawTexturePro(
+			imageTexture,
+			(Rectangle){0, 0, imageTexture.width, imageTexture.height},
+			(Rectangle){boundingBox.x, boundingBox.y, boundingBox.width, boundingBox.height},
+			(Vector2){},
+			0,
+			CLAY_COLOR_TO_RAY(tintColor));
+		break;
+	}
+	case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START: {
+		PRIV_BeginClippedScissorMode(boundingBox, damageRect);
+		break;
+	}
+	case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END: {
+		EndScissorMode();
+		if (damageRect) {
+			PRIV_BeginClippedScissorMode(*damageRect, NULL);
+		}
+		break;
+	}
+	case CLAY_RENDER_COMMAND_TYPE_CUSTOM: {
+		PRIV_CustomElementRender(&renderCommands.internalArray[0].boundingBox, renderCommand);
+		break;
+	}
+	default: {
+		printf("Error: unhandled render command.");
+		exit(1);
+	}
+	}
+}
+
+static void PRIV_AddBatchStats(const ClayRayBatchStats* stats) {
+	frame_batch_stats.commands += stats->commands;
+	frame_batch_stats.vertices += stats->vertices;
+	frame_batch_stats.geometryDraws += stats->geometryDraws;
+	frame_batch_stats.textDraws += stats->textDraws;
+	frame_batch_stats.imageDraws += stats->imageDraws;
+	frame_batch_stats.customDraws += stats->customDraws;
+	frame_batch_stats.scissorChanges += stats->scissorChanges;
+	frame_batch_stats.unbatchedShapeDraws += stats->unbatchedShapeDraws;
+}
+
+// Draws the render commands, when damageRect is set everything is clipped to it and commands outside of it are skipped.
+// Rectangles and borders go through the batch, so a run of them between two texts, images or scissors is one draw.
+static void PRIV_RenderCommands(Clay_RenderCommandArray renderCommands, const Font* fonts, const Clay_BoundingBox* damageRect) {
+	ClayRayBatch_Build(&render_batch, renderCommands, damageRect);
+	PRIV_AddBatchStats(&render_batch.stats);
+	for (int i = 0; i < render_batch.stepCount; i++) {
+		const ClayRayBatchStep* step = &render_batch.steps[i];
+		if (step->type == CLAYRAY_BATCH_STEP_GEOMETRY) {
+			PRIV_DrawBatchGeometry(step);
+		}
+		else {
+			PRIV_RenderCommand(renderCommands, Clay_RenderCommandArray_Get(&renderCommands, step->commandIndex), fonts, damageRect);
+		}
+	}
+}
+
+// Same rule DrawTextEx uses to advance the pen
+static float PRIV_GlyphAdvance(const Font* font, const int glyphIndex) {
+	if (font->glyphs[glyphIndex].advanceX != 0) return (float)font->glyphs[glyphIndex].advanceX;
+	return font->recs[glyphIndex].width + (float)font->glyphs[glyphIndex].offsetX;
+}
+
+static void PRIV_BuildFontMetrics(PRIV_FontMetrics* metrics, Font font) {
+	// Font failed to load, measure with the built in font it will be drawn with
+	if (!font.glyphs) {
+		font = GetFontDefault();
+	}
+	*metrics = (PRIV_FontMetrics){0};
+	// GetGlyphIndex falls back to '?' for missing codepoints, like drawing does
+	metrics->fallbackAdvance = PRIV_GlyphAdvance(&font, GetGlyphIndex(font, '?'));
+	for (int c = 32; c < 128; ++c) {
+		metrics->asciiAdvance[c] = PRIV_GlyphAdvance(&font, GetGlyphIndex(font, c));
+	}
+
+	metrics->codepoints = BC_Malloc(sizeof(int) * (size_t)font.glyphCount);
+	metrics->codepointAdvance = BC_Malloc(sizeof(float) * (size_t)font.glyphCount);
+	for (int i = 0; i < font.glyphCount; ++i) {
+		const int codepoint = font.glyphs[i].value;
+		if (codepoint < 128) continue;
+		// Insertion sort, glyphs are almost always already in codepoint order
+		int j = metrics->codepointCount++;
+		for (; j > 0 && metrics->codepoints[j - 1] > codepoint; --j) {
+			metrics->codepoints[j] = metrics->codepoints[j - 1];
+			metrics->codepointAdvance[j] = metrics->codepointAdvance[j - 1];
+		}
+		metrics->codepoints[j] = codepoint;
+		metrics->codepointAdvance[j] = PRIV_GlyphAdvance(&font, i);
+	}
+}
+
+static void PRIV_FreeFontMetrics(void) {
+	for (int i = 0; i < font_metrics_count; ++i) {
+		BC_Free(font_metrics[i].codepoints);
+		BC_Free(font_metrics[i].codepointAdvance);
+	}
+	if (font_metrics) BC_Free(font_metrics);
+	font_metrics = NULL;
+	font_metrics_count = 0;
+}
+
+// Fonts that were never passed to ClayRay_LoadFontMetrics get their table built on first use, and kept with the others
+static void PRIV_ExtendFontMetrics(const Font* fonts, const int fontCount) {
+	PRIV_FontMetrics* metrics = BC_Malloc(sizeof(PRIV_FontMetrics) * (size_t)fontCount);
+	if (font_metrics_count > 0) memcpy(metrics, font_metrics, sizeof(PRIV_FontMetrics) * (size_t)font_metrics_count);
+	for (int i = font_metrics_count; i < fontCount; ++i) {
+		PRIV_BuildFontMetrics(&metrics[i], fonts[i]);
+	}
+	if (font_metrics) BC_Free(font_metrics);
+	font_metrics = metrics;
+	font_metrics_count = fontCount;
+}
+
+static float PRIV_CodepointAdvance(const PRIV_FontMetrics* metrics, const int codepoint) {
+	int low = 0;
+	int high = metrics->codepointCount - 1;
+	while (low <= high) {
+		const int middle = (low + high) / 2;
+		if (metrics->codepoints[middle] < codepoint) low = middle + 1;
+		else if (metrics->codepoints[middle] > codepoint) high = middle - 1;
+		else return metrics->codepointAdvance[middle];
+	}
+	return metrics->fallbackAdvance;
+}
+
+// Decodes one multi-byte UTF-8 sequence without reading past the slice, invalid sequences decode to '?' one byte at a time
+static int PRIV_DecodeUtf8(const unsigned char* chars, const int remaining, int* outSize) {
+	*outSize = 1;
+	int length = 0;
+	int codepoint = 0;
+	if ((chars[0] & 0xE0) == 0xC0) { length = 2; codepoint = chars[0] & 0x1F; }
+	else if ((chars[0] & 0xF0) == 0xE0) { length = 3; codepoint = chars[0] & 0x0F; }
+	else if ((chars[0] & 0xF8) == 0xF0) { length = 4; codepoint = chars[0] & 0x07; }
+	if (length == 0 || length > remaining) return '?';
+	for (int i = 1; i < length; ++i) {
+		if ((chars[i] & 0xC0) != 0x80) return '?';
+		codepoint = (codepoint << 6) | (chars[i] & 0x3F);
+	}
+	*outSize = length;
+	return codepoint;
+}
+
+// True if any byte of word equals byte, the upper bytes of a 4 byte word are zero and never match
+static bool PRIV_WordHasByte(const uint64_t word, const unsigned char byte) {
+	const uint64_t x = word ^ (0x0101010101010101ull * byte);
+	return ((x - 0x0101010101010101ull) & ~x & 0x8080808080808080ull) != 0;
+}
+
 // ==========================================================
 // MARK: Public
 // ==========================================================
 
+void ClayRay_LoadFontMetrics(const Font* fonts, const int fontCount) {
+	PRIV_FreeFontMetrics();
+	font_metrics = BC_Malloc(sizeof(PRIV_FontMetrics) * (size_t)fontCount);
+	font_metrics_count = fontCount;
+	for (int i = 0; i < fontCount; ++i) {
+		PRIV_BuildFontMetrics(&font_metrics[i], fonts[i]);
+	}
+}
+
 Clay_Dimensions ClayRay_MeasureText(const Clay_StringSlice text, Clay_TextElementConfig* config, void* userData) {
 	// Measure string size for Font
 	Clay_Dimensions textSize = {0};
@@ -103,28 +349,66 @@ Clay_Dimensions ClayRay_MeasureText(const Clay_StringSlice text, Clay_TextElemen
 
 	const float textHeight = config->fontSize;
 	const Font* fonts = (Font*)userData;
-	Font fontToUse = fonts[config->fontId];
-	// Font failed to load, likely the fonts are in the wrong place relative to the execution dir.
-	// RayLib ships with a default font, so we can continue with that built in one.
-	if (!fontToUse.glyphs) {
-		fontToUse = GetFontDefault();
-	}
 
-	const float scaleFactor = config->fontSize / (float)fontToUse.baseSize;
-
-	for (int i = 0; i < text.length; ++i, lineCharCount++) {
-		if (text.chars[i] == '\n') {
+	if (config->fontId >= font_metrics_count) {
+		PRIV_ExtendFontMetrics(fonts, config->fontId + 1);
+	}
+	const PRIV_FontMetrics* metrics = &font_metrics[config->fontId];
+	const int baseSize = fonts[config->fontId].glyphs ? fonts[config->fontId].baseSize : GetFontDefault().baseSize;
+	const float scaleFactor = config->fontSize / (float)baseSize;
+
+	const unsigned char* chars = (const unsigned char*)text.chars;
+	int i = 0;
+	while (i < text.length) {
+		// Runs of 8 ASCII bytes without a line break, the common case, are summed without branching on each byte.
+		// Advances are whole numbers, so summing them in another order gives the exact same width.
+		if (i + 8 <= text.length) {
+			uint64_t word;
+			memcpy(&word, chars + i, sizeof(word));
+			if ((word & 0x8080808080808080ull) == 0 && !PRIV_WordHasByte(word, '\n')) {
+				const float* advance = metrics->asciiAdvance;
+				const float sum0 = advance[chars[i + 0]] + advance[chars[i + 4]];
+				const float sum1 = advance[chars[i + 1]] + advance[chars[i + 5]];
+				const float sum2 = advance[chars[i + 2]] + advance[chars[i + 6]];
+				const float sum3 = advance[chars[i + 3]] + advance[chars[i + 7]];
+				lineTextWidth += (sum0 + sum1) + (sum2 + sum3);
+				lineCharCount += 8;
+				i += 8;
+				continue;
+			}
+		}
+		if (i + 4 <= text.length) {
+			uint32_t word;
+			memcpy(&word, chars + i, sizeof(word));
+			if ((word & 0x80808080u) == 0 && !PRIV_WordHasByte(word, '\n')) {
+				const float* advance = metrics->asciiAdvance;
+				lineTextWidth += (advance[chars[i + 0]] + advance[chars[i + 1]]) + (advance[chars[i + 2]] + advance[chars[i + 3]]);
+				lineCharCount += 4;
+				i += 4;
+				continue;
+			}
+		}
+		if (chars[i] == '\n') {
 			maxTextWidth = fmax(maxTextWidth, lineTextWidth);
 			maxLineCharCount = CLAY__MAX(maxLineCharCount, lineCharCount);
 			lineTextWidth = 0;
-			lineCharCount = 0;
+			// The line break itself is counted as a character of the next line
+			lineCharCount = 1;
+			i++;
 			continue;
 		}
-		const int index = text.chars[i] - 32;
-		if (fontToUse.glyphs[index].advanceX != 0) lineTextWidth += fontToUse.glyphs[index].advanceX;
-		else lineTextWidth += fontToUse.recs[index].width + fontToUse.glyphs[index].offsetX;
+		if (chars[i] < 0x80) {
+			lineTextWidth += metrics->asciiAdvance[chars[i]];
+			i++;
+		}
+		else {
+			int codepointSize;
+			const int codepoint = PRIV_DecodeUtf8(chars + i, text.length - i, &codepointSize);
+			lineTextWidth += PRIV_CodepointAdvance(metrics, codepoint);
+			i += codepointSize;
+		}
+		lineCharCount++;
 	}
-
 	maxTextWidth = fmax(maxTextWidth, lineTextWidth);
 	maxLineCharCount = CLAY__MAX(maxLineCharCount, lineCharCount);
 
@@ -135,136 +419,62 @@ Clay_Dimensions ClayRay_MeasureText(const Clay_StringSlice text, Clay_TextElemen
 }
 
 void ClayRay_Render(Clay_RenderCommandArray renderCommands, const Font* fonts) {
-	for (int j = 0; j < renderCommands.length; j++) {
-		const Clay_RenderCommand* renderCommand = Clay_RenderCommandArray_Get(&renderCommands, j);
-		const Clay_BoundingBox boundingBox = {
-			roundf(renderCommand->boundingBox.x),
-			roundf(renderCommand->boundingBox.y),
-			roundf(renderCommand->boundingBox.width),
-			roundf(renderCommand->boundingBox.height)
-		};
-
-		switch (renderCommand->commandType) {
-		case CLAY_RENDER_COMMAND_TYPE_TEXT: {
-			const Clay_TextRenderData* textData = &renderCommand->renderData.text;
-			const Font fontToUse = fonts[textData->fontId];
-
-			const int strlen = textData->stringContents.length + 1;
-
-			if (strlen > temp_render_buffer_len) {
-				// Grow the temp buffer if we need a larger string
-				if (temp_render_buffer) BC_Free(temp_render_buffer);
-				temp_render_buffer = (char*)BC_Malloc(strlen);
-				temp_render_buffer_len = strlen;
-			}
+	// Whatever gets drawn now isn't in the retained target
+	retained_target_valid = false;
+	frame_batch_stats = (ClayRayBatchStats){0};
+	PRIV_RenderCommands(renderCommands, fonts, NULL);
+}
 
-			// Raylib uses standard C strings so isn't compatible with cheap slices, we need to clone the string to append null terminator
-			memcpy(temp_render_buffer, textData->stringContents.chars, textData->stringContents.length);
-			temp_render_buffer[textData->stringContents.length] = '\0';
-			DrawTextEx(
-				fontToUse,
-				temp_render_buffer,
-				(Vector2){boundingBox.x, boundingBox.y},
-				textData->fontSize, textData->letterSpacing,
-				CLAY_COLOR_TO_RAY(textData->textColor)
-			);
-
-			break;
-		}
-		case CLAY_RENDER_COMMAND_TYPE_IMAGE: {
-			const Texture2D imageTexture = *(Texture2D*)renderCommand->renderData.image.imageData;
-			Clay_Color tintColor = renderCommand->renderData.image.backgroundColor;
-			if (tintColor.r == 0 && tintColor.g == 0 && tintColor.b == 0 && tintColor.a == 0) {
-				tintColor = (Clay_Color){255, 255, 255, 255};
-			}
-			DrawTexturePro(
-				imageTexture,
-				(Rectangle){0, 0, imageTexture.width, imageTexture.height},
-				(Rectangle){boundingBox.x, boundingBox.y, boundingBox.width, boundingBox.height},
-				(Vector2){},
-				0,
-				CLAY_COLOR_TO_RAY(tintColor));
-			break;
-		}
-		case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START: {
-			BeginScissorMode((int)roundf(boundingBox.x), (int)roundf(boundingBox.y), (int)roundf(boundingBox.width), (int)roundf(boundingBox.height));
-			break;
-		}
-		case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END: {
+void ClayRay_RenderDiff(const Clay_LayoutDiff diff, const Font* fonts, const Color clearColor) {
+	const int width = GetScreenWidth();
+	const int height = GetScreenHeight();
+	if (retained_target.id == 0 || retained_target.texture.width != width || retained_target.texture.height != height) {
+		if (retained_target.id != 0) UnloadRenderTexture(retained_target);
+		retained_target = LoadRenderTexture(width, height);
+		retained_target_valid = false;
+	}
+
+	frame_batch_stats = (ClayRayBatchStats){0};
+	BeginTextureMode(retained_target);
+	if (diff.fullRedraw || !retained_target_valid) {
+		ClearBackground(clearColor);
+		PRIV_RenderCommands(diff.renderCommands, fonts, NULL);
+	}
+	else {
+		for (int i = 0; i < diff.damageRects.length; i++) {
+			const Clay_BoundingBox* damageRect = &diff.damageRects.internalArray[i];
+			PRIV_BeginClippedScissorMode(*damageRect, NULL);
+			ClearBackground(clearColor);
+			PRIV_RenderCommands(diff.renderCommands, fonts, damageRect);
 			EndScissorMode();
-			break;
-		}
-		case CLAY_RENDER_COMMAND_TYPE_RECTANGLE: {
-			const Clay_RectangleRenderData* config = &renderCommand->renderData.rectangle;
-			if (config->cornerRadius.topLeft > 0) {
-				const float radius = config->cornerRadius.topLeft * 2 / (float)(boundingBox.width > boundingBox.height ? boundingBox.height : boundingBox.width);
-				DrawRectangleRounded((Rectangle){boundingBox.x, boundingBox.y, boundingBox.width, boundingBox.height}, radius, 8,
-									 CLAY_COLOR_TO_RAY(config->backgroundColor));
-			}
-			else {
-				DrawRectangle(boundingBox.x, boundingBox.y, boundingBox.width, boundingBox.height, CLAY_COLOR_TO_RAY(config->backgroundColor));
-			}
-			break;
-		}
-		case CLAY_RENDER_COMMAND_TYPE_BORDER: {
-			const Clay_BorderRenderData* config = &renderCommand->renderData.border;
-			// Left border
-			if (config->width.left > 0) {
-				DrawRectangle((int)roundf(boundingBox.x), (int)roundf(boundingBox.y + config->cornerRadius.topLeft), config->width.left,
-							  (int)roundf(boundingBox.height - config->cornerRadius.topLeft - config->cornerRadius.bottomLeft), CLAY_COLOR_TO_RAY(config->color));
-			}
-			// Right border
-			if (config->width.right > 0) {
-				DrawRectangle((int)roundf(boundingBox.x + boundingBox.width - config->width.right), (int)roundf(boundingBox.y + config->cornerRadius.topRight),
-							  config->width.right, (int)roundf(boundingBox.height - config->cornerRadius.topRight - config->cornerRadius.bottomRight),
-							  CLAY_COLOR_TO_RAY(config->color));
-			}
-			// Top border
-			if (config->width.top > 0) {
-				DrawRectangle((int)roundf(boundingBox.x + config->cornerRadius.topLeft), (int)roundf(boundingBox.y),
-							  (int)roundf(boundingBox.width - config->cornerRadius.topLeft - config->cornerRadius.topRight), config->width.top,
-							  CLAY_COLOR_TO_RAY(config->color));
-			}
-			// Bottom border
-			if (config->width.bottom > 0) {
-				DrawRectangle((int)roundf(boundingBox.x + config->cornerRadius.bottomLeft), (int)roundf(boundingBox.y + boundingBox.height - config->width.bottom),
-							  (int)roundf(boundingBox.width - config->cornerRadius.bottomLeft - config->cornerRadius.bottomRight), config->width.bottom,
-							  CLAY_COLOR_TO_RAY(config->color));
-			}
-			if (config->cornerRadius.topLeft > 0) {
-				DrawRing((Vector2){roundf(boundingBox.x + config->cornerRadius.topLeft), roundf(boundingBox.y + config->cornerRadius.topLeft)},
-						 roundf(config->cornerRadius.topLeft - config->width.top), config->cornerRadius.topLeft, 180, 270, 10, CLAY_COLOR_TO_RAY(config->color));
-			}
-			if (config->cornerRadius.topRight > 0) {
-				DrawRing((Vector2){roundf(boundingBox.x + boundingBox.width - config->cornerRadius.topRight), roundf(boundingBox.y + config->cornerRadius.topRight)},
-						 roundf(config->cornerRadius.topRight - config->width.top), config->cornerRadius.topRight, 270, 360, 10, CLAY_COLOR_TO_RAY(config->color));
-			}
-			if (config->cornerRadius.bottomLeft > 0) {
-				DrawRing((Vector2){roundf(boundingBox.x + config->cornerRadius.bottomLeft), roundf(boundingBox.y + boundingBox.height - config->cornerRadius.bottomLeft)},
-						 roundf(config->cornerRadius.bottomLeft - config->width.bottom), config->cornerRadius.bottomLeft, 90, 180, 10, CLAY_COLOR_TO_RAY(config->color));
-			}
-			if (config->cornerRadius.bottomRight > 0) {
-				DrawRing((Vector2){
-							 roundf(boundingBox.x + boundingBox.width - config->cornerRadius.bottomRight),
-							 roundf(boundingBox.y + boundingBox.height - config->cornerRadius.bottomRight)
-						 }, roundf(config->cornerRadius.bottomRight - config->width.bottom), config->cornerRadius.bottomRight, 0.1, 90, 10,
-						 CLAY_COLOR_TO_RAY(config->color));
-			}
-			break;
-		}
-		case CLAY_RENDER_COMMAND_TYPE_CUSTOM: {
-			PRIV_CustomElementRender(&renderCommands.internalArray[0].boundingBox, renderCommand);
-			break;
-		}
-		default: {
-			printf("Error: unhandled render command.");
-			exit(1);
 		}
+		// Custom elements can animate without their render command changing, so they are always redrawn
+		for (int i = 0; i < diff.renderCommands.length; i++) {
+			const Clay_RenderCommand* renderCommand = &diff.renderCommands.internalArray[i];
+			if (renderCommand->commandType != CLAY_RENDER_COMMAND_TYPE_CUSTOM) continue;
+			PRIV_BeginClippedScissorMode(renderCommand->boundingBox, NULL);
+			ClearBackground(clearColor);
+			PRIV_RenderCommands(diff.renderCommands, fonts, &renderCommand->boundingBox);
+			EndScissorMode();
 		}
 	}
+	EndTextureMode();
+	retained_target_valid = true;
+
+	// Render textures are stored upside down
+	DrawTextureRec(retained_target.texture, (Rectangle){0, 0, (float)width, (float)-height}, (Vector2){0, 0}, WHITE);
+}
+
+ClayRayBatchStats ClayRay_GetBatchStats(void) {
+	return frame_batch_stats;
 }
 
 void ClayRay_Cleanup() {
+	if (retained_target.id != 0) UnloadRenderTexture(retained_target);
+	retained_target = (RenderTexture2D){0};
+	retained_target_valid = false;
+	PRIV_FreeFontMetrics();
+	ClayRayBatch_Free(&render_batch);
 	if (temp_render_buffer) BC_Free(temp_render_buffer);
 	temp_render_buffer = NULL;
 	temp_render_buffer_len = 0;
@@ -3,6 +3,7 @@
 
 #include "raylib.h"
 #include "../../3rdparty/clay.h"
+#include "clayray_batch.h"
 
 typedef enum CustomLayoutElementType {
 	CUSTOM_LAYOUT_ELEMENT_TYPE_3D_MODEL
@@ -28,8 +29,16 @@ typedef struct CustomLayoutElement {
 #define CLAY_COLOR_TO_RAY(color) (Color) { .r = (unsigned char)roundf(color.r), .g = (unsigned char)roundf(color.g), .b = (unsigned char)roundf(color.b), .a = (unsigned char)roundf(color.a) }
 
 void ClayRay_Render(Clay_RenderCommandArray renderCommands, const Font* fonts);
+// Draws into a retained render texture and only redraws the damaged regions of the diff, then blits it to the screen.
+// Replaces ClearBackground + ClayRay_Render, call it between BeginDrawing and EndDrawing.
+void ClayRay_RenderDiff(Clay_LayoutDiff diff, const Font* fonts, Color clearColor);
+// Batch counters of the last ClayRay_Render or ClayRay_RenderDiff, summed over its damage rects
+ClayRayBatchStats ClayRay_GetBatchStats(void);
 void ClayRay_Cleanup();
 
+// Precomputes the glyph advance tables ClayRay_MeasureText reads for fonts[0..fontCount), indexed by fontId.
+// Call it again whenever the fonts are reloaded.
+void ClayRay_LoadFontMetrics(const Font* fonts, int fontCount);
 Clay_Dimensions ClayRay_MeasureText(Clay_StringSlice text, Clay_TextElementConfig *config, void *userData);
 
 #endif //BR_TEST_RAYLIB_CLAY_RENDERER_RAYLIB_H
\ No newline at end of file
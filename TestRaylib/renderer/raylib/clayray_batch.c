@@ -0,0 +1,263 @@
+#include "clayray_batch.h"
+
+#include "math.h"
+#include "stdlib.h"
+
+// Same tessellation the per-command path asked raylib for
+#define CLAYRAY_BATCH_RECTANGLE_CORNER_SEGMENTS 8
+#define CLAYRAY_BATCH_BORDER_CORNER_SEGMENTS 10
+
+// Unit quarter circle, from 0 to 90 degrees, the other quadrants are rotations of it
+typedef struct PRIV_ArcTable {
+	float cos[CLAYRAY_BATCH_BORDER_CORNER_SEGMENTS + 1];
+	float sin[CLAYRAY_BATCH_BORDER_CORNER_SEGMENTS + 1];
+} PRIV_ArcTable;
+
+static PRIV_ArcTable rectangle_corner_arc;
+static PRIV_ArcTable border_corner_arc;
+static bool arc_tables_ready = false;
+
+// ==========================================================
+// MARK: Privates
+// ==========================================================
+
+static void PRIV_BuildArcTable(PRIV_ArcTable* table, const int segments) {
+	for (int i = 0; i <= segments; i++) {
+		const float angle = (float)i / (float)segments * 1.57079632679f;
+		table->cos[i] = cosf(angle);
+		table->sin[i] = sinf(angle);
+	}
+}
+
+// Quadrants follow raylib angles with y pointing down: 0 is bottom right, 1 bottom left, 2 top left, 3 top right
+static void PRIV_ArcPoint(const PRIV_ArcTable* table, const int i, const int quadrant, float* outX, float* outY) {
+	const float c = table->cos[i];
+	const float s = table->sin[i];
+	switch (quadrant) {
+	case 0: *outX = c; *outY = s; break;
+	case 1: *outX = -s; *outY = c; break;
+	case 2: *outX = -c; *outY = -s; break;
+	default: *outX = s; *outY = -c; break;
+	}
+}
+
+// Returns NULL when the buffer can't grow, the batch keeps its old buffer and the shape is dropped
+static ClayRayBatchVertex* PRIV_ReserveVertices(ClayRayBatch* batch, const int count) {
+	if (batch->vertexCount + count > batch->vertexCapacity) {
+		int capacity = batch->vertexCapacity > 0 ? batch->vertexCapacity : 1024;
+		while (capacity < batch->vertexCount + count) capacity *= 2;
+		// Plain realloc, the batch is also built by ClayBench which doesn't link BCore
+		ClayRayBatchVertex* vertices = realloc(batch->vertices, sizeof(ClayRayBatchVertex) * (size_t)capacity);
+		if (!vertices) return NULL;
+		batch->vertices = vertices;
+		batch->vertexCapacity = capacity;
+	}
+	ClayRayBatchVertex* vertices = &batch->vertices[batch->vertexCount];
+	batch->vertexCount += count;
+	return vertices;
+}
+
+// Returns false when the buffer can't grow, the batch keeps its old buffer and the step is dropped
+static bool PRIV_PushStep(ClayRayBatch* batch, const ClayRayBatchStep step) {
+	if (batch->stepCount == batch->stepCapacity) {
+		const int capacity = batch->stepCapacity > 0 ? batch->stepCapacity * 2 : 256;
+		ClayRayBatchStep* steps = realloc(batch->steps, sizeof(ClayRayBatchStep) * (size_t)capacity);
+		if (!steps) return false;
+		batch->steps = steps;
+		batch->stepCapacity = capacity;
+	}
+	batch->steps[batch->stepCount++] = step;
+	return true;
+}
+
+// Triangles are wound counter clockwise on screen, like raylib's own shapes, so backface culling keeps them
+static void PRIV_AddTriangle(ClayRayBatch* batch, float ax, float ay, float bx, float by, float cx, float cy, const Clay_Color color) {
+	if ((bx - ax) * (cy - ay) - (by - ay) * (cx - ax) > 0) {
+		const float tx = bx, ty = by;
+		bx = cx; by = cy;
+		cx = tx; cy = ty;
+	}
+	ClayRayBatchVertex* v = PRIV_ReserveVertices(batch, 3);
+	if (!v) return;
+	const uint8_t r = (uint8_t)roundf(color.r), g = (uint8_t)roundf(color.g), b = (uint8_t)roundf(color.b), a = (uint8_t)roundf(color.a);
+	v[0] = (ClayRayBatchVertex){ax, ay, r, g, b, a};
+	v[1] = (ClayRayBatchVertex){bx, by, r, g, b, a};
+	v[2] = (ClayRayBatchVertex){cx, cy, r, g, b, a};
+}
+
+static void PRIV_AddRectangle(ClayRayBatch* batch, const float x, const float y, const float width, const float height, const Clay_Color color) {
+	if (width <= 0 || height <= 0) return;
+	PRIV_AddTriangle(batch, x, y, x, y + height, x + width, y + height, color);
+	PRIV_AddTriangle(batch, x, y, x + width, y + height, x + width, y, color);
+}
+
+static void PRIV_AddCornerFan(ClayRayBatch* batch, const float centerX, const float centerY, const float radius, const int quadrant, const Clay_Color color) {
+	float previousX, previousY;
+	PRIV_ArcPoint(&rectangle_corner_arc, 0, quadrant, &previousX, &previousY);
+	for (int i = 1; i <= CLAYRAY_BATCH_RECTANGLE_CORNER_SEGMENTS; i++) {
+		float x, y;
+		PRIV_ArcPoint(&rectangle_corner_arc, i, quadrant, &x, &y);
+		PRIV_AddTriangle(batch, centerX, centerY, centerX + previousX * radius, centerY + previousY * radius, centerX + x * radius, centerY + y * radius, color);
+		previousX = x;
+		previousY = y;
+	}
+}
+
+static void PRIV_AddCornerRing(ClayRayBatch* batch, const float centerX, const float centerY, float innerRadius, float outerRadius, const int quadrant, const Clay_Color color) {
+	if (innerRadius > outerRadius) {
+		const float swap = innerRadius;
+		innerRadius = outerRadius;
+		outerRadius = swap;
+	}
+	if (innerRadius < 0) innerRadius = 0;
+	if (outerRadius <= 0) return;
+	float previousX, previousY;
+	PRIV_ArcPoint(&border_corner_arc, 0, quadrant, &previousX, &previousY);
+	for (int i = 1; i <= CLAYRAY_BATCH_BORDER_CORNER_SEGMENTS; i++) {
+		float x, y;
+		PRIV_ArcPoint(&border_corner_arc, i, quadrant, &x, &y);
+		const float innerPreviousX = centerX + previousX * innerRadius, innerPreviousY = centerY + previousY * innerRadius;
+		const float outerX = centerX + x * outerRadius, outerY = centerY + y * outerRadius;
+		PRIV_AddTriangle(batch, innerPreviousX, innerPreviousY, centerX + previousX * outerRadius, centerY + previousY * outerRadius, outerX, outerY, color);
+		if (innerRadius > 0) {
+			PRIV_AddTriangle(batch, innerPreviousX, innerPreviousY, outerX, outerY, centerX + x * innerRadius, centerY + y * innerRadius, color);
+		}
+		previousX = x;
+		previousY = y;
+	}
+}
+
+// Mirrors DrawRectangleRounded: one radius for every corner, taken from the top left and capped at half the shortest side
+static void PRIV_AddRectangleCommand(ClayRayBatch* batch, const Clay_BoundingBox box, const Clay_RectangleRenderData* config) {
+	const Clay_Color color = config->backgroundColor;
+	batch->stats.unbatchedShapeDraws++;
+	if (config->cornerRadius.topLeft <= 0) {
+		PRIV_AddRectangle(batch, box.x, box.y, box.width, box.height, color);
+		return;
+	}
+	const float radius = fminf(config->cornerRadius.topLeft, fminf(box.width, box.height) / 2);
+	PRIV_AddRectangle(batch, box.x + radius, box.y, box.width - radius * 2, box.height, color);
+	PRIV_AddRectangle(batch, box.x, box.y + radius, radius, box.height - radius * 2, color);
+	PRIV_AddRectangle(batch, box.x + box.width - radius, box.y + radius, radius, box.height - radius * 2, color);
+	PRIV_AddCornerFan(batch, box.x + radius, box.y + radius, radius, 2, color);
+	PRIV_AddCornerFan(batch, box.x + box.width - radius, box.y + radius, radius, 3, color);
+	PRIV_AddCornerFan(batch, box.x + box.width - radius, box.y + box.height - radius, radius, 0, color);
+	PRIV_AddCornerFan(batch, box.x + radius, box.y + box.height - radius, radius, 1, color);
+}
+
+// Same sides and rings the per-command path drew, including its rounding
+static void PRIV_AddBorderCommand(ClayRayBatch* batch, const Clay_BoundingBox box, const Clay_BorderRenderData* config) {
+	const Clay_Color color = config->color;
+	const Clay_CornerRadius radius = config->cornerRadius;
+	if (config->width.left > 0) {
+		PRIV_AddRectangle(batch, roundf(box.x), roundf(box.y + radius.topLeft), config->width.left, roundf(box.height - radius.topLeft - radius.bottomLeft), color);
+		batch->stats.unbatchedShapeDraws++;
+	}
+	if (config->width.right > 0) {
+		PRIV_AddRectangle(batch, roundf(box.x + box.width - config->width.right), roundf(box.y + radius.topRight), config->width.right,
+		                  roundf(box.height - radius.topRight - radius.bottomRight), color);
+		batch->stats.unbatchedShapeDraws++;
+	}
+	if (config->width.top > 0) {
+		PRIV_AddRectangle(batch, roundf(box.x + radius.topLeft), roundf(box.y), roundf(box.width - radius.topLeft - radius.topRight), config->width.top, color);
+		batch->stats.unbatchedShapeDraws++;
+	}
+	if (config->width.bottom > 0) {
+		PRIV_AddRectangle(batch, roundf(box.x + radius.bottomLeft), roundf(box.y + box.height - config->width.bottom),
+		                  roundf(box.width - radius.bottomLeft - radius.bottomRight), config->width.bottom, color);
+		batch->stats.unbatchedShapeDraws++;
+	}
+	if (radius.topLeft > 0) {
+		PRIV_AddCornerRing(batch, roundf(box.x + radius.topLeft), roundf(box.y + radius.topLeft), roundf(radius.topLeft - config->width.top), radius.topLeft, 2, color);
+		batch->stats.unbatchedShapeDraws++;
+	}
+	if (radius.topRight > 0) {
+		PRIV_AddCornerRing(batch, roundf(box.x + box.width - radius.topRight), roundf(box.y + radius.topRight), roundf(radius.topRight - config->width.top), radius.topRight, 3,
+		                   color);
+		batch->stats.unbatchedShapeDraws++;
+	}
+	if (radius.bottomLeft > 0) {
+		PRIV_AddCornerRing(batch, roundf(box.x + radius.bottomLeft), roundf(box.y + box.height - radius.bottomLeft), roundf(radius.bottomLeft - config->width.bottom),
+		                   radius.bottomLeft, 1, color);
+		batch->stats.unbatchedShapeDraws++;
+	}
+	if (radius.bottomRight > 0) {
+		PRIV_AddCornerRing(batch, roundf(box.x + box.width - radius.bottomRight), roundf(box.y + box.height - radius.bottomRight),
+		                   roundf(radius.bottomRight - config->width.bottom), radius.bottomRight, 0, color);
+		batch->stats.unbatchedShapeDraws++;
+	}
+}
+
+static bool PRIV_BoundingBoxesOverlap(const Clay_BoundingBox a, const Clay_BoundingBox b) {
+	return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+}
+
+// ==========================================================
+// MARK: Public
+// ==========================================================
+
+void ClayRayBatch_Build(ClayRayBatch* batch, Clay_RenderCommandArray renderCommands, const Clay_BoundingBox* damageRect) {
+	if (!arc_tables_ready) {
+		PRIV_BuildArcTable(&rectangle_corner_arc, CLAYRAY_BATCH_RECTANGLE_CORNER_SEGMENTS);
+		PRIV_BuildArcTable(&border_corner_arc, CLAYRAY_BATCH_BORDER_CORNER_SEGMENTS);
+		arc_tables_ready = true;
+	}
+	batch->vertexCount = 0;
+	batch->stepCount = 0;
+	batch->stats = (ClayRayBatchStats){0};
+
+	for (int j = 0; j < renderCommands.length; j++) {
+		const Clay_RenderCommand* renderCommand = Clay_RenderCommandArray_Get(&renderCommands, j);
+		const bool isScissor = renderCommand->commandType == CLAY_RENDER_COMMAND_TYPE_SCISSOR_START || renderCommand->commandType == CLAY_RENDER_COMMAND_TYPE_SCISSOR_END;
+		if (damageRect && !isScissor && !PRIV_BoundingBoxesOverlap(renderCommand->boundingBox, *damageRect)) {
+			continue;
+		}
+		batch->stats.commands++;
+
+		if (renderCommand->commandType != CLAY_RENDER_COMMAND_TYPE_RECTANGLE && renderCommand->commandType != CLAY_RENDER_COMMAND_TYPE_BORDER) {
+			switch (renderCommand->commandType) {
+			case CLAY_RENDER_COMMAND_TYPE_TEXT: batch->stats.textDraws++; break;
+			case CLAY_RENDER_COMMAND_TYPE_IMAGE: batch->stats.imageDraws++; break;
+			case CLAY_RENDER_COMMAND_TYPE_CUSTOM: batch->stats.customDraws++; break;
+			default: batch->stats.scissorChanges += isScissor ? 1 : 0; break;
+			}
+			PRIV_PushStep(batch, (ClayRayBatchStep){.type = CLAYRAY_BATCH_STEP_COMMAND, .commandIndex = j});
+			continue;
+		}
+
+		const Clay_BoundingBox boundingBox = {
+			roundf(renderCommand->boundingBox.x),
+			roundf(renderCommand->boundingBox.y),
+			roundf(renderCommand->boundingBox.width),
+			roundf(renderCommand->boundingBox.height)
+		};
+		const int firstVertex = batch->vertexCount;
+		if (renderCommand->commandType == CLAY_RENDER_COMMAND_TYPE_RECTANGLE) {
+			PRIV_AddRectangleCommand(batch, boundingBox, &renderCommand->renderData.rectangle);
+		}
+		else {
+			PRIV_AddBorderCommand(batch, boundingBox, &renderCommand->renderData.border);
+		}
+		if (batch->vertexCount == firstVertex) continue;
+
+		// Consecutive shapes share one range, it only breaks on a command raylib has to draw itself
+		ClayRayBatchStep* last = batch->stepCount > 0 ? &batch->steps[batch->stepCount - 1] : NULL;
+		if (last && last->type == CLAYRAY_BATCH_STEP_GEOMETRY) {
+			last->vertexCount += batch->vertexCount - firstVertex;
+		}
+		else if (PRIV_PushStep(batch, (ClayRayBatchStep){.type = CLAYRAY_BATCH_STEP_GEOMETRY, .firstVertex = firstVertex, .vertexCount = batch->vertexCount - firstVertex})) {
+			batch->stats.geometryDraws++;
+		}
+		else {
+			// No step draws these vertices, so they are given back
+			batch->vertexCount = firstVertex;
+		}
+	}
+	batch->stats.vertices = batch->vertexCount;
+}
+
+void ClayRayBatch_Free(ClayRayBatch* batch) {
+	free(batch->vertices);
+	free(batch->steps);
+	*batch = (ClayRayBatch){0};
+}
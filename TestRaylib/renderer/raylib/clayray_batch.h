@@ -0,0 +1,57 @@
+#ifndef BR_TEST_RAYLIB_CLAY_RENDERER_RAYLIB_BATCH_H
+#define BR_TEST_RAYLIB_CLAY_RENDERER_RAYLIB_BATCH_H
+
+#include <stdint.h>
+
+#include "../../3rdparty/clay.h"
+
+// Turns a frame of clay render commands into triangles, without touching raylib, so the same batches can be inspected without a GPU.
+// Rectangles, borders and rounded corners of consecutive commands are appended to one vertex range,
+// every other command (text, image, scissor, custom) ends the range and is replayed by the renderer in order.
+
+typedef struct ClayRayBatchVertex {
+	float x, y;
+	uint8_t r, g, b, a;
+} ClayRayBatchVertex;
+
+typedef enum ClayRayBatchStepType {
+	// Draws vertices[firstVertex..firstVertex + vertexCount) as a triangle list
+	CLAYRAY_BATCH_STEP_GEOMETRY,
+	// Replays renderCommands[commandIndex]
+	CLAYRAY_BATCH_STEP_COMMAND
+} ClayRayBatchStepType;
+
+typedef struct ClayRayBatchStep {
+	ClayRayBatchStepType type;
+	int firstVertex;
+	int vertexCount;
+	int commandIndex;
+} ClayRayBatchStep;
+
+typedef struct ClayRayBatchStats {
+	int commands;
+	int vertices;
+	int geometryDraws;
+	int textDraws;
+	int imageDraws;
+	int customDraws;
+	int scissorChanges;
+	// Shape draw calls the per-command path issued for the same frame, one per rectangle, border side and corner ring
+	int unbatchedShapeDraws;
+} ClayRayBatchStats;
+
+typedef struct ClayRayBatch {
+	ClayRayBatchVertex* vertices;
+	int vertexCount;
+	int vertexCapacity;
+	ClayRayBatchStep* steps;
+	int stepCount;
+	int stepCapacity;
+	ClayRayBatchStats stats;
+} ClayRayBatch;
+
+// Rebuilds the batch from a frame, keeping its buffers. When damageRect is set, commands outside of it are skipped.
+void ClayRayBatch_Build(ClayRayBatch* batch, Clay_RenderCommandArray renderCommands, const Clay_BoundingBox* damageRect);
+void ClayRayBatch_Free(ClayRayBatch* batch);
+
+#endif //BR_TEST_RAYLIB_CLAY_RENDERER_RAYLIB_BATCH_H
@@ -6,9 +6,77 @@
 #include <SDL3/SDL.h>
 #include <SDL3_ttf/SDL_ttf.h>
 
-static int MAX_CIRCLE_SEGMENTS = 24;
+// Most segments SDL_Clay_RenderBorder uses per corner, up to SDL_CLAY_MAX_ARC_SEGMENTS, its geometry is sized from the actual counts
+#define SDL_CLAY_MAX_BORDER_SEGMENTS 16
+// Largest segment count any corner asks the unit arc tables for
+#define SDL_CLAY_MAX_ARC_SEGMENTS 24
+#define SDL_CLAY_ROUNDED_RECT_MAX_VERTICES (4 + 4 * (SDL_CLAY_MAX_ARC_SEGMENTS + 1) * 2)
+#define SDL_CLAY_ROUNDED_RECT_MAX_INDICES (6 + 24 + 24 + 4 * SDL_CLAY_MAX_ARC_SEGMENTS * 9)
+// Meshes not drawn for this many frames are freed, like the text cache
+#define SDL_CLAY_MESH_CACHE_MAX_UNUSED_FRAMES 2
+// Smallest block of the frame arena, shapes release their temporaries so it holds the largest shape many times over
+#define SDL_CLAY_FRAME_ARENA_MIN_BLOCK_SIZE (64 * 1024)
+#define SDL_CLAY_FRAME_ARENA_ALIGNMENT 16
+
+// unit_arcs[n][i] is the point at i/n of a quarter circle from 0 to 90 degrees, other quarters are rotations of it
+static SDL_FPoint unit_arcs[SDL_CLAY_MAX_ARC_SEGMENTS + 1][SDL_CLAY_MAX_ARC_SEGMENTS + 1];
+static bool unit_arcs_ready = false;
+
+struct SDL_Clay_CachedMesh {
+    // Built with the rect at the origin, the indices share the allocation of the vertices
+    SDL_Vertex *vertices;
+    int *indices;
+    int32_t vertexCount;
+    int32_t indexCount;
+    float width;
+    float height;
+    float cornerRadius;
+    Clay_Color color;
+    uint32_t generation;
+    // Next item in the bucket, or in the free list, 0 ends both
+    int32_t nextIndex;
+};
+
+// Same lifetime Clay gives its text measurements, a text object not drawn for this many frames is destroyed
+#define SDL_CLAY_TEXT_CACHE_MAX_UNUSED_FRAMES 2
+
+struct SDL_Clay_CachedText {
+    TTF_Text *text;
+    uint64_t hash;
+    int32_t length;
+    uint16_t fontId;
+    uint16_t fontSize;
+    Uint32 color;
+    uint32_t generation;
+    // Next item in the bucket, or in the free list, 0 ends both
+    int32_t nextIndex;
+};
+
+static void SDL_Clay_InitUnitArcs(void) {
+    for (int n = 1; n <= SDL_CLAY_MAX_ARC_SEGMENTS; n++) {
+        for (int i = 0; i <= n; i++) {
+            const float angle = (float)i / (float)n * 0.5f * SDL_PI_F;
+            unit_arcs[n][i] = (SDL_FPoint){ SDL_cosf(angle), SDL_sinf(angle) };
+        }
+    }
+    unit_arcs_ready = true;
+}
+
+// Point i of n on the quarter circle starting at quadrant * 90 degrees, y pointing down
+static inline SDL_FPoint SDL_Clay_ArcPoint(const int quadrant, const int n, const int i) {
+    const SDL_FPoint p = unit_arcs[n][i];
+    switch (quadrant & 3) {
+        case 0: return (SDL_FPoint){ p.x, p.y };
+        case 1: return (SDL_FPoint){ -p.y, p.x };
+        case 2: return (SDL_FPoint){ -p.x, -p.y };
+        default: return (SDL_FPoint){ p.y, -p.x };
+    }
+}
 
-static void SDL_Clay_RenderFillRoundedRect(Clay_SDL3RendererData *rendererData, const SDL_FRect rect, const float cornerRadius, const Clay_Color _color) {
+// Builds the antialiased mesh of a rounded rect at the origin, into buffers of SDL_CLAY_ROUNDED_RECT_MAX_* elements
+static void SDL_Clay_BuildRoundedRectMesh(const float width, const float height, const float cornerRadius, const Clay_Color _color,
+                                          SDL_Vertex *vertices, int *indices, int32_t *outVertexCount, int32_t *outIndexCount) {
+    const SDL_FRect rect = { 0.0f, 0.0f, width, height };
     // 1. Setup Colors
     // Inner color is full opacity, Outer color is transparent (for AA fade)
     const float alpha = _color.a / 255.0f;
@@ -22,7 +90,7 @@ static void SDL_Clay_RenderFillRoundedRect(Clay_SDL3RendererData *rendererData,
     const float r = SDL_clamp(cornerRadius, 0.0f, minDimension);
 
     // Adaptive segments based on size (small corners don't need 32 segments)
-    int numSegments = SDL_clamp((int)(r * 0.5f), 6, MAX_CIRCLE_SEGMENTS);
+    int numSegments = SDL_clamp((int)(r * 0.5f), 6, SDL_CLAY_MAX_ARC_SEGMENTS);
 
     // Radii for the inner solid core and the outer transparent edge
     // If r is very small, we clamp inner to 0 to avoid artifacts.
@@ -30,21 +98,8 @@ static void SDL_Clay_RenderFillRoundedRect(Clay_SDL3RendererData *rendererData,
     const float rOuter = r + halfStroke;
 
     // 3. Memory Allocation
-    // 4 Hubs + 4 Corners * (numSegments + 1) * 2 (Inner+Outer)
-    int totalVertices = 4 + 4 * (numSegments + 1) * 2;
-
-    // Indices:
-    // Center Quad: 6
-    // 4 Side Quads (Fill): 4 * 6
-    // 4 Side Quads (AA): 4 * 6
-    // 4 Corner Fans (Fill): 4 * numSegments * 3
-    // 4 Corner Strips (AA): 4 * numSegments * 6
-    int totalIndices = 6 + 24 + 24 + 4 * numSegments * 3 + 4 * numSegments * 6;
-
-    // Use stack if small, or heap if large (SDL_small_alloc handles this logic automatically in internal SDL, but here we use VLA or standard heap)
-    // For standard UI, this fits on the stack easily.
-    SDL_Vertex vertices[totalVertices];
-    int indices[totalIndices];
+    // 4 Hubs + 4 Corners * (numSegments + 1) * 2 (Inner+Outer) vertices, and the center, side and corner triangles,
+    // at most the SDL_CLAY_ROUNDED_RECT_MAX_* the caller's buffers hold
 
     int vIndex = 0;
     int iIndex = 0;
@@ -78,11 +133,12 @@ static void SDL_Clay_RenderFillRoundedRect(Clay_SDL3RendererData *rendererData,
     // We loop through 4 corners. For each corner, we generate the arc vertices.
     // We also bridge the gap to the *next* corner (Side connections).
 
-    struct { float startAng; float endAng; int hubIdx; } corners[4] = {
-        { SDL_PI_F,       1.5f * SDL_PI_F, 0 }, // TL
-        { 1.5f * SDL_PI_F, 2.0f * SDL_PI_F, 1 }, // TR
-        { 0.0f,           0.5f * SDL_PI_F, 2 }, // BR
-        { 0.5f * SDL_PI_F, SDL_PI_F,       3 }  // BL
+    // Quadrants of the unit arc tables: 2 is PI -> 1.5 PI, 3 is 1.5 PI -> 2 PI, 0 is 0 -> 0.5 PI, 1 is 0.5 PI -> PI
+    struct { int quadrant; int hubIdx; } corners[4] = {
+        { 2, 0 }, // TL
+        { 3, 1 }, // TR
+        { 0, 2 }, // BR
+        { 1, 3 }  // BL
     };
 
     // Keep track of the indices of the "Start" and "End" of the previous corner's arc
@@ -94,16 +150,15 @@ static void SDL_Clay_RenderFillRoundedRect(Clay_SDL3RendererData *rendererData,
 
     for (int c = 0; c < 4; c++) {
         int currentHub = corners[c].hubIdx;
-        float angleStep = (corners[c].endAng - corners[c].startAng) / (float)numSegments;
 
         int currentCornerStartInner = -1;
         int currentCornerStartOuter = -1;
 
         // Generate Arc Vertices
         for (int i = 0; i <= numSegments; i++) {
-            float angle = corners[c].startAng + (float)i * angleStep;
-            float cosA = SDL_cosf(angle);
-            float sinA = SDL_sinf(angle);
+            const SDL_FPoint arc = SDL_Clay_ArcPoint(corners[c].quadrant, numSegments, i);
+            float cosA = arc.x;
+            float sinA = arc.y;
 
             // Inner Vertex (Full Alpha)
             SDL_FPoint posInner = { hubs[c].x + cosA * rInner, hubs[c].y + sinA * rInner };
@@ -199,8 +254,356 @@ static void SDL_Clay_RenderFillRoundedRect(Clay_SDL3RendererData *rendererData,
     indices[iIndex++] = firstCornerStartOuter;
     indices[iIndex++] = firstCornerStartInner;
 
-    // 6. Draw
-    SDL_RenderGeometry(rendererData->renderer, NULL, vertices, vIndex, indices, iIndex);
+    *outVertexCount = vIndex;
+    *outIndexCount = iIndex;
+}
+
+static uint32_t SDL_Clay_HashMesh(const float width, const float height, const float cornerRadius, const Clay_Color color) {
+    const float key[7] = { width, height, cornerRadius, color.r, color.g, color.b, color.a };
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < 7; i++) {
+        uint32_t bits;
+        SDL_memcpy(&bits, &key[i], sizeof(bits));
+        hash = (hash ^ bits) * 16777619u;
+    }
+    return hash ^ (hash >> 15);
+}
+
+static void SDL_Clay_FreeCachedMesh(SDL_Clay_MeshCache *cache, const int32_t index) {
+    SDL_free(cache->items[index].vertices);
+    cache->items[index] = (SDL_Clay_CachedMesh) { .nextIndex = cache->freeListHead };
+    cache->freeListHead = index;
+}
+
+// Called once per frame, frees the meshes that weren't drawn recently
+static void SDL_Clay_BeginMeshCacheFrame(SDL_Clay_MeshCache *cache) {
+    cache->generation++;
+    if (!cache->items || !cache->buckets) return;
+    for (int32_t bucket = 0; bucket < SDL_CLAY_MESH_CACHE_CAPACITY; bucket++) {
+        int32_t *link = &cache->buckets[bucket];
+        while (*link != 0) {
+            const int32_t index = *link;
+            SDL_Clay_CachedMesh *item = &cache->items[index];
+            if (cache->generation - item->generation > SDL_CLAY_MESH_CACHE_MAX_UNUSED_FRAMES) {
+                *link = item->nextIndex;
+                SDL_Clay_FreeCachedMesh(cache, index);
+            } else {
+                link = &item->nextIndex;
+            }
+        }
+    }
+}
+
+// Finds or builds the mesh, returns NULL when the cache is full and the mesh was built into the scratch buffers instead
+static const SDL_Clay_CachedMesh *SDL_Clay_GetRoundedRectMesh(SDL_Clay_MeshCache *cache, const float width, const float height, const float cornerRadius,
+                                                              const Clay_Color color, SDL_Vertex *scratchVertices, int *scratchIndices,
+                                                              int32_t *outVertexCount, int32_t *outIndexCount) {
+    if (!cache->items) {
+        // Item 0 is reserved to mean "no next item"
+        cache->items = SDL_calloc(SDL_CLAY_MESH_CACHE_CAPACITY + 1, sizeof(SDL_Clay_CachedMesh));
+        cache->buckets = SDL_calloc(SDL_CLAY_MESH_CACHE_CAPACITY, sizeof(int32_t));
+        if (!cache->items || !cache->buckets) {
+            // Neither is kept, the meshes are built uncached and the next draw tries again
+            SDL_free(cache->items);
+            SDL_free(cache->buckets);
+            cache->items = NULL;
+            cache->buckets = NULL;
+        }
+        cache->itemCount = cache->items ? 1 : 0;
+    }
+    const uint32_t hash = SDL_Clay_HashMesh(width, height, cornerRadius, color);
+    const int32_t bucket = (int32_t) (hash % SDL_CLAY_MESH_CACHE_CAPACITY);
+    if (cache->itemCount > 0) {
+        for (int32_t index = cache->buckets[bucket]; index != 0; index = cache->items[index].nextIndex) {
+            SDL_Clay_CachedMesh *item = &cache->items[index];
+            if (item->width == width && item->height == height && item->cornerRadius == cornerRadius &&
+                item->color.r == color.r && item->color.g == color.g && item->color.b == color.b && item->color.a == color.a) {
+                item->generation = cache->generation;
+                cache->hits++;
+                return item;
+            }
+        }
+    }
+
+    SDL_Clay_BuildRoundedRectMesh(width, height, cornerRadius, color, scratchVertices, scratchIndices, outVertexCount, outIndexCount);
+    cache->meshesBuilt++;
+
+    int32_t index = cache->freeListHead;
+    if (index != 0) {
+        cache->freeListHead = cache->items[index].nextIndex;
+    } else if (cache->itemCount > 0 && cache->itemCount <= SDL_CLAY_MESH_CACHE_CAPACITY) {
+        index = cache->itemCount++;
+    } else {
+        return NULL;
+    }
+    const size_t vertexBytes = sizeof(SDL_Vertex) * (size_t) *outVertexCount;
+    SDL_Vertex *vertices = SDL_malloc(vertexBytes + sizeof(int) * (size_t) *outIndexCount);
+    if (!vertices) {
+        cache->items[index] = (SDL_Clay_CachedMesh) { .nextIndex = cache->freeListHead };
+        cache->freeListHead = index;
+        return NULL;
+    }
+    int *indices = (int *) ((char *) vertices + vertexBytes);
+    SDL_memcpy(vertices, scratchVertices, vertexBytes);
+    SDL_memcpy(indices, scratchIndices, sizeof(int) * (size_t) *outIndexCount);
+    cache->items[index] = (SDL_Clay_CachedMesh) {
+        .vertices = vertices,
+        .indices = indices,
+        .vertexCount = *outVertexCount,
+        .indexCount = *outIndexCount,
+        .width = width,
+        .height = height,
+        .cornerRadius = cornerRadius,
+        .color = color,
+        .generation = cache->generation,
+        .nextIndex = cache->buckets[bucket],
+    };
+    cache->buckets[bucket] = index;
+    return &cache->items[index];
+}
+
+void SDL_Clay_DestroyMeshCache(Clay_SDL3RendererData *rendererData) {
+    SDL_Clay_MeshCache *cache = &rendererData->meshCache;
+    for (int32_t i = 1; i < cache->itemCount; i++) {
+        SDL_free(cache->items[i].vertices);
+    }
+    SDL_free(cache->items);
+    SDL_free(cache->buckets);
+    *cache = (SDL_Clay_MeshCache) { 0 };
+}
+
+// Makes room for one more shape, returns false when the buffers can't grow
+static bool SDL_Clay_ReserveGeometry(SDL_Clay_GeometryBatch *batch, const int32_t vertexCount, const int32_t indexCount) {
+    if (batch->vertexCount + vertexCount > batch->vertexCapacity) {
+        int32_t capacity = SDL_max(batch->vertexCapacity * 2, 1024);
+        while (capacity < batch->vertexCount + vertexCount) capacity *= 2;
+        SDL_Vertex *vertices = SDL_realloc(batch->vertices, sizeof(SDL_Vertex) * (size_t) capacity);
+        if (!vertices) return false;
+        batch->vertices = vertices;
+        batch->vertexCapacity = capacity;
+    }
+    if (batch->indexCount + indexCount > batch->indexCapacity) {
+        int32_t capacity = SDL_max(batch->indexCapacity * 2, 2048);
+        while (capacity < batch->indexCount + indexCount) capacity *= 2;
+        int *indices = SDL_realloc(batch->indices, sizeof(int) * (size_t) capacity);
+        if (!indices) return false;
+        batch->indices = indices;
+        batch->indexCapacity = capacity;
+    }
+    return true;
+}
+
+static void SDL_Clay_SetBlendMode(Clay_SDL3RendererData *rendererData, const SDL_BlendMode blendMode) {
+    SDL_Clay_RenderState *state = &rendererData->renderState;
+    if (state->blendModeKnown && state->blendMode == blendMode) {
+        rendererData->drawStats.stateChangesSkipped++;
+        return;
+    }
+    SDL_SetRenderDrawBlendMode(rendererData->renderer, blendMode);
+    state->blendModeKnown = true;
+    state->blendMode = blendMode;
+    rendererData->drawStats.stateChangesIssued++;
+}
+
+static void SDL_Clay_SetDrawColor(Clay_SDL3RendererData *rendererData, const SDL_Color color) {
+    SDL_Clay_RenderState *state = &rendererData->renderState;
+    if (state->drawColorKnown && state->drawColor.r == color.r && state->drawColor.g == color.g && state->drawColor.b == color.b && state->drawColor.a == color.a) {
+        rendererData->drawStats.stateChangesSkipped++;
+        return;
+    }
+    SDL_SetRenderDrawColor(rendererData->renderer, color.r, color.g, color.b, color.a);
+    state->drawColorKnown = true;
+    state->drawColor = color;
+    rendererData->drawStats.stateChangesIssued++;
+}
+
+static bool SDL_Clay_IsClipRectSet(const SDL_Clay_RenderState *state, const SDL_Rect *clipRect) {
+    if (!state->clipRectKnown) return false;
+    if (!clipRect) return !state->clipEnabled;
+    return state->clipEnabled && state->clipRect.x == clipRect->x && state->clipRect.y == clipRect->y &&
+           state->clipRect.w == clipRect->w && state->clipRect.h == clipRect->h;
+}
+
+static void SDL_Clay_SetTarget(Clay_SDL3RendererData *rendererData, SDL_Texture *target) {
+    SDL_Clay_RenderState *state = &rendererData->renderState;
+    if (state->targetKnown && state->target == target) {
+        rendererData->drawStats.stateChangesSkipped++;
+        return;
+    }
+    SDL_SetRenderTarget(rendererData->renderer, target);
+    state->targetKnown = true;
+    state->target = target;
+    // Every render target has its own clip rect
+    state->clipRectKnown = false;
+    rendererData->drawStats.stateChangesIssued++;
+}
+
+// Submits the batched shapes, must run before anything that draws differently or changes the clip rect
+static void SDL_Clay_FlushGeometry(Clay_SDL3RendererData *rendererData) {
+    SDL_Clay_GeometryBatch *batch = &rendererData->geometryBatch;
+    if (batch->indexCount == 0) return;
+    // Untextured geometry uses the draw blend mode, the antialiased edges need blending
+    SDL_Clay_SetBlendMode(rendererData, SDL_BLENDMODE_BLEND);
+    SDL_RenderGeometry(rendererData->renderer, NULL, batch->vertices, batch->vertexCount, batch->indices, batch->indexCount);
+    rendererData->drawStats.geometryDraws++;
+    batch->vertexCount = 0;
+    batch->indexCount = 0;
+}
+
+// Appends a shape translated by (offsetX, offsetY), it is drawn on its own when the batch can't grow
+static void SDL_Clay_AppendGeometry(Clay_SDL3RendererData *rendererData, const SDL_Vertex *vertices, const int32_t vertexCount,
+                                    const int *indices, const int32_t indexCount, const float offsetX, const float offsetY) {
+    SDL_Clay_GeometryBatch *batch = &rendererData->geometryBatch;
+    if (!SDL_Clay_ReserveGeometry(batch, vertexCount, indexCount)) {
+        SDL_Clay_FlushGeometry(rendererData);
+        if (!SDL_Clay_ReserveGeometry(batch, vertexCount, indexCount)) {
+            SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Failed to grow the geometry batch");
+            return;
+        }
+    }
+    SDL_Vertex *destVertices = batch->vertices + batch->vertexCount;
+    for (int32_t i = 0; i < vertexCount; i++) {
+        destVertices[i] = vertices[i];
+        destVertices[i].position.x += offsetX;
+        destVertices[i].position.y += offsetY;
+    }
+    int *destIndices = batch->indices + batch->indexCount;
+    for (int32_t i = 0; i < indexCount; i++) {
+        destIndices[i] = indices[i] + batch->vertexCount;
+    }
+    batch->vertexCount += vertexCount;
+    batch->indexCount += indexCount;
+    rendererData->drawStats.batchedShapes++;
+}
+
+struct SDL_Clay_ArenaBlock {
+    SDL_Clay_ArenaBlock *next;
+    size_t capacity;
+    size_t used;
+};
+
+#define SDL_CLAY_ARENA_BLOCK_HEADER_SIZE ((sizeof(SDL_Clay_ArenaBlock) + SDL_CLAY_FRAME_ARENA_ALIGNMENT - 1) & ~(size_t) (SDL_CLAY_FRAME_ARENA_ALIGNMENT - 1))
+
+// Where the arena was before a shape built its temporaries, they are released once the shape is in the geometry batch
+typedef struct {
+    SDL_Clay_ArenaBlock *block;
+    size_t used;
+} SDL_Clay_ArenaMark;
+
+static SDL_Clay_ArenaBlock *SDL_Clay_AllocateArenaBlock(SDL_Clay_FrameArena *arena, const size_t capacity) {
+    SDL_Clay_ArenaBlock *block = SDL_malloc(SDL_CLAY_ARENA_BLOCK_HEADER_SIZE + capacity);
+    if (!block) return NULL;
+    *block = (SDL_Clay_ArenaBlock) { .next = arena->blocks, .capacity = capacity };
+    arena->blocks = block;
+    arena->blocksAllocated++;
+    return block;
+}
+
+// Returns size bytes that stay valid until the arena is reset, or NULL when out of memory
+static void *SDL_Clay_FrameArenaAllocate(SDL_Clay_FrameArena *arena, size_t size) {
+    size = (size + SDL_CLAY_FRAME_ARENA_ALIGNMENT - 1) & ~(size_t) (SDL_CLAY_FRAME_ARENA_ALIGNMENT - 1);
+    SDL_Clay_ArenaBlock *block = arena->blocks;
+    if (!block || block->capacity - block->used < size) {
+        // Earlier allocations stay where they are, the new block is chained in front of them
+        const size_t capacity = SDL_max(SDL_max(size, (size_t) SDL_CLAY_FRAME_ARENA_MIN_BLOCK_SIZE), block ? block->capacity * 2 : 0);
+        block = SDL_Clay_AllocateArenaBlock(arena, capacity);
+        if (!block) return NULL;
+    }
+    void *memory = (char *) block + SDL_CLAY_ARENA_BLOCK_HEADER_SIZE + block->used;
+    block->used += size;
+    size_t used = 0;
+    for (; block; block = block->next) {
+        used += block->used;
+    }
+    arena->peakBytes = SDL_max(arena->peakBytes, used);
+    return memory;
+}
+
+static SDL_Clay_ArenaMark SDL_Clay_FrameArenaMark(const SDL_Clay_FrameArena *arena) {
+    return (SDL_Clay_ArenaMark) { .block = arena->blocks, .used = arena->blocks ? arena->blocks->used : 0 };
+}
+
+static void SDL_Clay_FrameArenaRelease(SDL_Clay_FrameArena *arena, const SDL_Clay_ArenaMark mark) {
+    // Blocks chained since the mark are emptied but kept until the reset merges them
+    for (SDL_Clay_ArenaBlock *block = arena->blocks; block != mark.block; block = block->next) {
+        block->used = 0;
+    }
+    if (mark.block) {
+        mark.block->used = mark.used;
+    }
+}
+
+static void SDL_Clay_ResetFrameArena(SDL_Clay_FrameArena *arena) {
+    size_t capacity = 0;
+    for (SDL_Clay_ArenaBlock *block = arena->blocks; block; block = block->next) {
+        capacity += block->capacity;
+    }
+    if (arena->blocks && arena->blocks->next) {
+        // The last frame needed more than one block, one block of their combined size fits the next one
+        while (arena->blocks) {
+            SDL_Clay_ArenaBlock *next = arena->blocks->next;
+            SDL_free(arena->blocks);
+            arena->blocks = next;
+        }
+        SDL_Clay_AllocateArenaBlock(arena, capacity);
+    } else if (arena->blocks) {
+        arena->blocks->used = 0;
+    }
+}
+
+void SDL_Clay_DestroyFrameArena(Clay_SDL3RendererData *rendererData) {
+    SDL_Clay_FrameArena *arena = &rendererData->frameArena;
+    while (arena->blocks) {
+        SDL_Clay_ArenaBlock *next = arena->blocks->next;
+        SDL_free(arena->blocks);
+        arena->blocks = next;
+    }
+    *arena = (SDL_Clay_FrameArena) { 0 };
+}
+
+void SDL_Clay_DestroyGeometryBatch(Clay_SDL3RendererData *rendererData) {
+    SDL_free(rendererData->geometryBatch.vertices);
+    SDL_free(rendererData->geometryBatch.indices);
+    rendererData->geometryBatch = (SDL_Clay_GeometryBatch) { 0 };
+}
+
+SDL_Clay_DrawStats SDL_Clay_GetDrawStats(const Clay_SDL3RendererData *rendererData) {
+    return rendererData->drawStats;
+}
+
+static void SDL_Clay_RenderFillRect(Clay_SDL3RendererData *rendererData, const SDL_FRect rect, const Clay_Color color) {
+    // Same rounding as SDL_SetRenderDrawColor with the color cast to Uint8
+    const SDL_FColor fillColor = { (Uint8) color.r / 255.0f, (Uint8) color.g / 255.0f, (Uint8) color.b / 255.0f, (Uint8) color.a / 255.0f };
+    const SDL_Vertex vertices[4] = {
+        { { rect.x, rect.y }, fillColor, { 0, 0 } },
+        { { rect.x + rect.w, rect.y }, fillColor, { 0, 0 } },
+        { { rect.x + rect.w, rect.y + rect.h }, fillColor, { 0, 0 } },
+        { { rect.x, rect.y + rect.h }, fillColor, { 0, 0 } },
+    };
+    static const int indices[6] = { 0, 1, 2, 0, 2, 3 };
+    SDL_Clay_AppendGeometry(rendererData, vertices, 4, indices, 6, 0, 0);
+}
+
+// Identical rounded rects share one cached mesh, drawing one only translates its vertices into the batch
+static void SDL_Clay_RenderFillRoundedRect(Clay_SDL3RendererData *rendererData, const SDL_FRect rect, const float cornerRadius, const Clay_Color color) {
+    if (!unit_arcs_ready) SDL_Clay_InitUnitArcs();
+    const SDL_Clay_ArenaMark mark = SDL_Clay_FrameArenaMark(&rendererData->frameArena);
+    SDL_Vertex *scratchVertices = SDL_Clay_FrameArenaAllocate(&rendererData->frameArena, sizeof(SDL_Vertex) * SDL_CLAY_ROUNDED_RECT_MAX_VERTICES);
+    int *scratchIndices = SDL_Clay_FrameArenaAllocate(&rendererData->frameArena, sizeof(int) * SDL_CLAY_ROUNDED_RECT_MAX_INDICES);
+    if (!scratchVertices || !scratchIndices) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Failed to allocate rounded rect geometry");
+    } else {
+        int32_t vertexCount = 0;
+        int32_t indexCount = 0;
+        const SDL_Clay_CachedMesh *mesh = SDL_Clay_GetRoundedRectMesh(&rendererData->meshCache, rect.w, rect.h, cornerRadius, color, scratchVertices, scratchIndices, &vertexCount, &indexCount);
+        if (mesh) {
+            SDL_Clay_AppendGeometry(rendererData, mesh->vertices, mesh->vertexCount, mesh->indices, mesh->indexCount, rect.x, rect.y);
+        } else {
+            SDL_Clay_AppendGeometry(rendererData, scratchVertices, vertexCount, scratchIndices, indexCount, rect.x, rect.y);
+        }
+    }
+    // Also when only one of the allocations succeeded
+    SDL_Clay_FrameArenaRelease(&rendererData->frameArena, mark);
 }
 
 static void SDL_Clay_RenderBorder(Clay_SDL3RendererData *rendererData, const SDL_FRect rect, const Clay_BorderRenderData *config) {
@@ -245,17 +648,31 @@ static void SDL_Clay_RenderBorder(Clay_SDL3RendererData *rendererData, const SDL
         { r.bottomLeft,  {rect.x + r.bottomLeft, rect.y + rect.h - r.bottomLeft}, 0.5f * SDL_PI_F, SDL_PI_F, (float)config->width.bottom, (float)config->width.left }
     };
 
+    if (!unit_arcs_ready) SDL_Clay_InitUnitArcs();
+    // Quadrants of the unit arc tables, matching the angles above
+    const int quadrants[4] = { 2, 3, 0, 1 };
+
     // 4. Memory Estimation
-    // Max segments per corner
-    int maxSegments = 16;
-    // Vertices: 4 corners * (maxSegments+1) * 4 points + 4 connection points
-    // This is an over-estimation, but safe for stack allocation
-    int totalVertices = 4 * (maxSegments + 2) * 4;
-    // Indices: (Triangles per step * steps)
-    int totalIndices = totalVertices * 6;
-
-    SDL_Vertex vertices[totalVertices];
-    int indices[totalIndices];
+    // Adaptive segments: fewer for small radii, more for large
+    int cornerSegments[4];
+    int totalSlices = 0;
+    for (int c = 0; c < 4; c++) {
+        cornerSegments[c] = SDL_min(SDL_max(2, (int)(corners[c].radius * 0.5f)), SDL_CLAY_MAX_BORDER_SEGMENTS);
+        totalSlices += cornerSegments[c] + 1;
+    }
+    // Vertices: 4 points per slice
+    int totalVertices = totalSlices * 4;
+    // Indices: 3 quads from every slice but the first to the one before it, plus the 4 stitched straight sides
+    int totalIndices = (totalSlices - 1 + 4) * 18;
+
+    const SDL_Clay_ArenaMark mark = SDL_Clay_FrameArenaMark(&rendererData->frameArena);
+    SDL_Vertex *vertices = SDL_Clay_FrameArenaAllocate(&rendererData->frameArena, sizeof(SDL_Vertex) * (size_t) totalVertices);
+    int *indices = SDL_Clay_FrameArenaAllocate(&rendererData->frameArena, sizeof(int) * (size_t) totalIndices);
+    if (!vertices || !indices) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Failed to allocate border geometry");
+        SDL_Clay_FrameArenaRelease(&rendererData->frameArena, mark);
+        return;
+    }
     int vCount = 0;
     int iCount = 0;
 
@@ -266,18 +683,16 @@ static void SDL_Clay_RenderBorder(Clay_SDL3RendererData *rendererData, const SDL
     for (int c = 0; c < 4; c++) {
         CornerDef *cd = &corners[c];
 
-        // Adaptive segments: fewer for small radii, more for large
-        int numSegments = SDL_max(2, (int)(cd->radius * 0.5f));
-        if (numSegments > maxSegments) numSegments = maxSegments;
+        int numSegments = cornerSegments[c];
 
         for (int i = 0; i <= numSegments; i++) {
             // Lerp angle and width
             float t = (float)i / (float)numSegments; // 0.0 to 1.0
-            float currentAngle = cd->startAngle + t * (cd->endAngle - cd->startAngle);
             float currentWidth = cd->widthStart + t * (cd->widthEnd - cd->widthStart);
 
-            float cosA = SDL_cosf(currentAngle);
-            float sinA = SDL_sinf(currentAngle);
+            const SDL_FPoint arc = SDL_Clay_ArcPoint(quadrants[c], numSegments, i);
+            float cosA = arc.x;
+            float sinA = arc.y;
 
             // Calculate Edge Radii
             // Outer is fixed by the corner radius.
@@ -347,9 +762,8 @@ static void SDL_Clay_RenderBorder(Clay_SDL3RendererData *rendererData, const SDL
 
     // Recalculate where corners start/end in the buffer to stitch them
     for(int c=0; c<4; c++) {
-        int numSegs = SDL_max(2, (int)(corners[c].radius * 0.5f));
         startOfCorner[c] = currentV;
-        currentV += (numSegs + 1) * 4;
+        currentV += (cornerSegments[c] + 1) * 4;
         endOfCorner[c] = currentV - 4; // Pointing to the start of the last slice of this corner
     }
 
@@ -371,19 +785,247 @@ static void SDL_Clay_RenderBorder(Clay_SDL3RendererData *rendererData, const SDL
     }
 
     // 7. Render
-    SDL_RenderGeometry(rendererData->renderer, NULL, vertices, vCount, indices, iCount);
+    SDL_Clay_AppendGeometry(rendererData, vertices, vCount, indices, iCount, 0, 0);
+    SDL_Clay_FrameArenaRelease(&rendererData->frameArena, mark);
 }
 
-void SDL_Clay_RenderText(const Clay_SDL3RendererData *rendererData, const SDL_FRect rect, const Clay_TextRenderData *config) {
-    TTF_Font *font = rendererData->fonts[config->fontId];
-    TTF_SetFontSize(font, config->fontSize);
+static uint64_t SDL_Clay_HashText(const Clay_TextRenderData *config, const Uint32 color) {
+    // FNV-1a over the string, then the rest of the key
+    uint64_t hash = 14695981039346656037ull;
+    for (int32_t i = 0; i < config->stringContents.length; i++) {
+        hash = (hash ^ (uint8_t) config->stringContents.chars[i]) * 1099511628211ull;
+    }
+    hash = (hash ^ config->fontId) * 1099511628211ull;
+    hash = (hash ^ config->fontSize) * 1099511628211ull;
+    return (hash ^ color) * 1099511628211ull;
+}
+
+// Returns false and keeps the current buckets when the new ones can't be allocated
+static bool SDL_Clay_SetTextCacheBucketCount(SDL_Clay_TextCache *cache, const int32_t bucketCount) {
+    int32_t *buckets = SDL_calloc((size_t) bucketCount, sizeof(int32_t));
+    if (!buckets) return false;
+    SDL_free(cache->buckets);
+    cache->buckets = buckets;
+    cache->bucketCount = bucketCount;
+    // Free items have no text, item 0 is never used
+    for (int32_t i = 1; i < cache->itemCount; i++) {
+        SDL_Clay_CachedText *item = &cache->items[i];
+        if (!item->text) continue;
+        const int32_t bucket = (int32_t) (item->hash & (uint64_t) (bucketCount - 1));
+        item->nextIndex = cache->buckets[bucket];
+        cache->buckets[bucket] = i;
+    }
+    return true;
+}
+
+static int32_t SDL_Clay_AllocateCachedText(SDL_Clay_TextCache *cache) {
+    if (cache->freeListHead != 0) {
+        const int32_t index = cache->freeListHead;
+        cache->freeListHead = cache->items[index].nextIndex;
+        return index;
+    }
+    if (cache->itemCount == cache->itemCapacity) {
+        const int32_t capacity = cache->itemCapacity > 0 ? cache->itemCapacity * 2 : 64;
+        SDL_Clay_CachedText *items = SDL_realloc(cache->items, sizeof(SDL_Clay_CachedText) * (size_t) capacity);
+        if (!items) return 0;
+        cache->items = items;
+        cache->itemCapacity = capacity;
+        // Reserve index 0 to mean "no next item"
+        if (cache->itemCount == 0) {
+            cache->items[0] = (SDL_Clay_CachedText) { 0 };
+            cache->itemCount = 1;
+        }
+    }
+    return cache->itemCount++;
+}
+
+static void SDL_Clay_FreeCachedText(SDL_Clay_TextCache *cache, const int32_t index) {
+    SDL_Clay_CachedText *item = &cache->items[index];
+    TTF_DestroyText(item->text);
+    cache->textsDestroyed++;
+    *item = (SDL_Clay_CachedText) { .nextIndex = cache->freeListHead };
+    cache->freeListHead = index;
+}
+
+// Destroys the text objects drawn with evictedFont, or when it is NULL the ones that weren't drawn recently
+static void SDL_Clay_PruneTextCache(SDL_Clay_TextCache *cache, const SDL_Clay_PooledFont *evictedFont) {
+    for (int32_t bucket = 0; bucket < cache->bucketCount; bucket++) {
+        int32_t *link = &cache->buckets[bucket];
+        while (*link != 0) {
+            const int32_t index = *link;
+            SDL_Clay_CachedText *item = &cache->items[index];
+            const bool prune = evictedFont
+                ? item->fontId == evictedFont->fontId && item->fontSize == evictedFont->fontSize
+                : cache->generation - item->generation > SDL_CLAY_TEXT_CACHE_MAX_UNUSED_FRAMES;
+            if (prune) {
+                *link = item->nextIndex;
+                SDL_Clay_FreeCachedText(cache, index);
+            } else {
+                link = &item->nextIndex;
+            }
+        }
+    }
+}
+
+// Called once per frame
+static void SDL_Clay_BeginTextCacheFrame(SDL_Clay_TextCache *cache) {
+    cache->generation++;
+    SDL_Clay_PruneTextCache(cache, NULL);
+}
+
+// Sets outUncached when the text couldn't be stored, the caller then destroys it after drawing
+static TTF_Text *SDL_Clay_GetCachedText(Clay_SDL3RendererData *rendererData, TTF_Font *font, const Clay_TextRenderData *config, bool *outUncached) {
+    SDL_Clay_TextCache *cache = &rendererData->textCache;
+    const Uint32 color = (Uint32) (Uint8) config->textColor.r << 24 | (Uint32) (Uint8) config->textColor.g << 16 | (Uint32) (Uint8) config->textColor.b << 8 | (Uint8) config->textColor.a;
+    const uint64_t hash = SDL_Clay_HashText(config, color);
+    // Without buckets the text is drawn uncached
+    const bool cacheAvailable = cache->bucketCount > 0 || SDL_Clay_SetTextCacheBucketCount(cache, 64);
+
+    int32_t index = cacheAvailable ? cache->buckets[hash & (uint64_t) (cache->bucketCount - 1)] : 0;
+    while (index != 0) {
+        SDL_Clay_CachedText *item = &cache->items[index];
+        if (item->hash == hash && item->length == config->stringContents.length && item->fontId == config->fontId && item->fontSize == config->fontSize &&
+            item->color == color && SDL_memcmp(item->text->text, config->stringContents.chars, (size_t) item->length) == 0) {
+            item->generation = cache->generation;
+            cache->hits++;
+            return item->text;
+        }
+        index = item->nextIndex;
+    }
+
     TTF_Text *text = TTF_CreateText(rendererData->textEngine, font, config->stringContents.chars, config->stringContents.length);
+    if (!text) return NULL;
     TTF_SetTextColor(text, (Uint8)config->textColor.r, (Uint8)config->textColor.g, (Uint8)config->textColor.b, (Uint8)config->textColor.a);
+    cache->textsCreated++;
+
+    index = cacheAvailable ? SDL_Clay_AllocateCachedText(cache) : 0;
+    if (index == 0) {
+        *outUncached = true;
+        return text;
+    }
+    cache->items[index] = (SDL_Clay_CachedText) {
+        .text = text,
+        .hash = hash,
+        .length = config->stringContents.length,
+        .fontId = config->fontId,
+        .fontSize = config->fontSize,
+        .color = color,
+        .generation = cache->generation,
+    };
+    // Keep chains short, one bucket per live item. If the buckets can't grow the item goes into the current ones.
+    if (cache->itemCount <= cache->bucketCount || !SDL_Clay_SetTextCacheBucketCount(cache, cache->bucketCount * 2)) {
+        const int32_t bucket = (int32_t) (hash & (uint64_t) (cache->bucketCount - 1));
+        cache->items[index].nextIndex = cache->buckets[bucket];
+        cache->buckets[bucket] = index;
+    }
+    return text;
+}
+
+TTF_Font *SDL_Clay_GetFont(Clay_SDL3RendererData *rendererData, const uint16_t fontId, const uint16_t fontSize) {
+    SDL_Clay_FontPool *pool = &rendererData->fontPool;
+    pool->useCounter++;
+    for (int32_t i = 0; i < pool->count; i++) {
+        SDL_Clay_PooledFont *item = &pool->items[i];
+        if (item->fontId == fontId && item->fontSize == fontSize) {
+            item->lastUsed = pool->useCounter;
+            return item->font;
+        }
+    }
+
+    TTF_Font *font = TTF_CopyFont(rendererData->fonts[fontId]);
+    if (!font || !TTF_SetFontSize(font, fontSize)) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Failed to open font %d at size %d: %s", fontId, fontSize, SDL_GetError());
+        if (font) TTF_CloseFont(font);
+        // Still draws something, at whatever size the loaded font has
+        return rendererData->fonts[fontId];
+    }
+    pool->fontsOpened++;
+
+    int32_t slot = pool->count;
+    if (pool->count == SDL_CLAY_FONT_POOL_CAPACITY) {
+        slot = 0;
+        for (int32_t i = 1; i < pool->count; i++) {
+            if (pool->items[i].lastUsed < pool->items[slot].lastUsed) slot = i;
+        }
+        // Cached text objects keep a reference to their font
+        SDL_Clay_PruneTextCache(&rendererData->textCache, &pool->items[slot]);
+        TTF_CloseFont(pool->items[slot].font);
+        pool->fontsClosed++;
+    } else {
+        pool->count++;
+    }
+    pool->items[slot] = (SDL_Clay_PooledFont) { .font = font, .fontId = fontId, .fontSize = fontSize, .lastUsed = pool->useCounter };
+    return font;
+}
+
+void SDL_Clay_DestroyFontPool(Clay_SDL3RendererData *rendererData) {
+    SDL_Clay_FontPool *pool = &rendererData->fontPool;
+    for (int32_t i = 0; i < pool->count; i++) {
+        TTF_CloseFont(pool->items[i].font);
+    }
+    *pool = (SDL_Clay_FontPool) { 0 };
+}
+
+void SDL_Clay_RenderText(Clay_SDL3RendererData *rendererData, const SDL_FRect rect, const Clay_TextRenderData *config) {
+    TTF_Font *font = SDL_Clay_GetFont(rendererData, config->fontId, config->fontSize);
+    bool uncached = false;
+    TTF_Text *text = SDL_Clay_GetCachedText(rendererData, font, config, &uncached);
+    if (!text) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Failed to create text: %s", SDL_GetError());
+        return;
+    }
     TTF_DrawRendererText(text, rect.x, rect.y);
-    TTF_DestroyText(text);
+    if (uncached) {
+        TTF_DestroyText(text);
+        rendererData->textCache.textsDestroyed++;
+    }
 }
 
-void SDL_Clay_RenderClayCommands(Clay_SDL3RendererData *rendererData, Clay_RenderCommandArray *renderCommands)
+void SDL_Clay_DestroyTextCache(Clay_SDL3RendererData *rendererData) {
+    SDL_Clay_TextCache *cache = &rendererData->textCache;
+    for (int32_t i = 1; i < cache->itemCount; i++) {
+        if (cache->items[i].text) {
+            TTF_DestroyText(cache->items[i].text);
+        }
+    }
+    SDL_free(cache->items);
+    SDL_free(cache->buckets);
+    *cache = (SDL_Clay_TextCache) { 0 };
+}
+
+// Sets the clip rect, NULL disables clipping. The batched shapes are only flushed when it actually changes.
+static void SDL_Clay_ApplyClipRect(Clay_SDL3RendererData *rendererData, const SDL_Rect *clipRect) {
+    SDL_Clay_RenderState *state = &rendererData->renderState;
+    if (SDL_Clay_IsClipRectSet(state, clipRect)) {
+        rendererData->drawStats.stateChangesSkipped++;
+        return;
+    }
+    SDL_Clay_FlushGeometry(rendererData);
+    SDL_SetRenderClipRect(rendererData->renderer, clipRect);
+    state->clipRectKnown = true;
+    state->clipEnabled = clipRect != NULL;
+    state->clipRect = clipRect ? *clipRect : (SDL_Rect) { 0 };
+    rendererData->drawStats.stateChangesIssued++;
+    rendererData->drawStats.clipChanges++;
+}
+
+static void SDL_Clay_SetClipRect(Clay_SDL3RendererData *rendererData, const SDL_Rect *clipRect, const SDL_Rect *damageRect) {
+    if (!damageRect) {
+        SDL_Clay_ApplyClipRect(rendererData, clipRect);
+        return;
+    }
+    if (!clipRect) {
+        SDL_Clay_ApplyClipRect(rendererData, damageRect);
+        return;
+    }
+    // An empty clip rect still clips, everything inside this scissor is then outside the damaged region
+    SDL_Rect intersection = { 0 };
+    SDL_GetRectIntersection(clipRect, damageRect, &intersection);
+    SDL_Clay_ApplyClipRect(rendererData, &intersection);
+}
+
+// When damageRect is set, everything is clipped to it and commands outside of it are skipped
+static void SDL_Clay_RenderClayCommandsClipped(Clay_SDL3RendererData *rendererData, Clay_RenderCommandArray *renderCommands, const SDL_Rect *damageRect)
 {
     for (int32_t i = 0; i < renderCommands->length; i++) {
 
@@ -391,20 +1033,27 @@ void SDL_Clay_RenderClayCommands(Clay_SDL3RendererData *rendererData, Clay_Rende
         const Clay_BoundingBox bounding_box = renderCommand->boundingBox;
         const SDL_FRect rect = { bounding_box.x, bounding_box.y, bounding_box.width, bounding_box.height };
 
+        if (damageRect && renderCommand->commandType != CLAY_RENDER_COMMAND_TYPE_SCISSOR_START && renderCommand->commandType != CLAY_RENDER_COMMAND_TYPE_SCISSOR_END) {
+            const SDL_FRect damage = { (float) damageRect->x, (float) damageRect->y, (float) damageRect->w, (float) damageRect->h };
+            if (!SDL_HasRectIntersectionFloat(&rect, &damage)) {
+                continue;
+            }
+        }
+
         switch (renderCommand->commandType) {
             case CLAY_RENDER_COMMAND_TYPE_RECTANGLE: {
                 const Clay_RectangleRenderData *config = &renderCommand->renderData.rectangle;
-                SDL_SetRenderDrawBlendMode(rendererData->renderer, SDL_BLENDMODE_BLEND);
-                SDL_SetRenderDrawColor(rendererData->renderer, (Uint8)config->backgroundColor.r, (Uint8)config->backgroundColor.g, (Uint8)config->backgroundColor.b, (Uint8)config->backgroundColor.a);
                 if (config->cornerRadius.topLeft > 0) {
                     SDL_Clay_RenderFillRoundedRect(rendererData, rect, config->cornerRadius.topLeft, config->backgroundColor);
                 } else {
-                    SDL_RenderFillRect(rendererData->renderer, &rect);
+                    SDL_Clay_RenderFillRect(rendererData, rect, config->backgroundColor);
                 }
             }
             break;
             case CLAY_RENDER_COMMAND_TYPE_TEXT: {
+                SDL_Clay_FlushGeometry(rendererData);
                 SDL_Clay_RenderText(rendererData, rect, &renderCommand->renderData.text);
+                rendererData->drawStats.textDraws++;
             }
             break;
             case CLAY_RENDER_COMMAND_TYPE_BORDER: {
@@ -413,29 +1062,98 @@ void SDL_Clay_RenderClayCommands(Clay_SDL3RendererData *rendererData, Clay_Rende
             break;
             case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START: {
                 const Clay_BoundingBox boundingBox = renderCommand->boundingBox;
-                SDL_SetRenderClipRect(
-                    rendererData->renderer,
+                SDL_Clay_SetClipRect(
+                    rendererData,
                     &(SDL_Rect){
                         .x = (int) boundingBox.x,
                         .y = (int) boundingBox.y,
                         .w = (int) boundingBox.width,
                         .h = (int) boundingBox.height,
-                    }
+                    },
+                    damageRect
                 );
             }
             break;
             case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END: {
-                SDL_SetRenderClipRect(rendererData->renderer, NULL);
+                SDL_Clay_SetClipRect(rendererData, NULL, damageRect);
             }
             break;
             case CLAY_RENDER_COMMAND_TYPE_IMAGE: {
                 SDL_Texture *texture = renderCommand->renderData.image.imageData;
                 const SDL_FRect dest = { rect.x, rect.y, rect.w, rect.h };
+                SDL_Clay_FlushGeometry(rendererData);
                 SDL_RenderTexture(rendererData->renderer, texture, NULL, &dest);
+                rendererData->drawStats.imageDraws++;
             }
             break;
             default:
                 SDL_Log("Unknown render command type: %d", renderCommand->commandType);
         }
     }
+    SDL_Clay_FlushGeometry(rendererData);
+}
+
+static void SDL_Clay_BeginFrame(Clay_SDL3RendererData *rendererData) {
+    SDL_Clay_BeginTextCacheFrame(&rendererData->textCache);
+    SDL_Clay_BeginMeshCacheFrame(&rendererData->meshCache);
+    rendererData->drawStats = (SDL_Clay_DrawStats) { 0 };
+    rendererData->renderState = (SDL_Clay_RenderState) { 0 };
+    SDL_Clay_ResetFrameArena(&rendererData->frameArena);
+}
+
+void SDL_Clay_RenderClayCommands(Clay_SDL3RendererData *rendererData, Clay_RenderCommandArray *renderCommands)
+{
+    // Whatever gets drawn now isn't in the retained target
+    rendererData->retainedTargetValid = false;
+    SDL_Clay_BeginFrame(rendererData);
+    SDL_Clay_RenderClayCommandsClipped(rendererData, renderCommands, NULL);
+}
+
+void SDL_Clay_RenderClayCommandsDiff(Clay_SDL3RendererData *rendererData, Clay_LayoutDiff *layoutDiff, SDL_Color clearColor)
+{
+    SDL_Renderer *renderer = rendererData->renderer;
+    int width, height;
+    SDL_GetCurrentRenderOutputSize(renderer, &width, &height);
+    if (!rendererData->retainedTarget || rendererData->retainedTarget->w != width || rendererData->retainedTarget->h != height) {
+        if (rendererData->retainedTarget) {
+            SDL_DestroyTexture(rendererData->retainedTarget);
+        }
+        rendererData->retainedTarget = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
+        rendererData->retainedTargetValid = false;
+        if (!rendererData->retainedTarget) {
+            SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Failed to create retained render target: %s", SDL_GetError());
+            SDL_Clay_RenderClayCommands(rendererData, &layoutDiff->renderCommands);
+            return;
+        }
+        SDL_SetTextureBlendMode(rendererData->retainedTarget, SDL_BLENDMODE_NONE);
+    }
+
+    SDL_Clay_BeginFrame(rendererData);
+    SDL_Texture *previousTarget = SDL_GetRenderTarget(renderer);
+    SDL_Clay_SetTarget(rendererData, rendererData->retainedTarget);
+    SDL_Clay_SetDrawColor(rendererData, clearColor);
+    if (layoutDiff->fullRedraw || !rendererData->retainedTargetValid) {
+        SDL_RenderClear(renderer);
+        SDL_Clay_RenderClayCommandsClipped(rendererData, &layoutDiff->renderCommands, NULL);
+    } else {
+        for (int32_t i = 0; i < layoutDiff->damageRects.length; i++) {
+            const Clay_BoundingBox damage = layoutDiff->damageRects.internalArray[i];
+            // Rounded outwards, so antialiased edges of the damaged commands are covered too
+            const int x = (int) SDL_floorf(damage.x);
+            const int y = (int) SDL_floorf(damage.y);
+            const SDL_Rect damageRect = { x, y, (int) SDL_ceilf(damage.x + damage.width) - x, (int) SDL_ceilf(damage.y + damage.height) - y };
+            const SDL_FRect clearRect = { (float) damageRect.x, (float) damageRect.y, (float) damageRect.w, (float) damageRect.h };
+            // SDL_RenderClear ignores the clip rect, so the region is cleared with an unblended fill instead
+            SDL_Clay_ApplyClipRect(rendererData, &damageRect);
+            SDL_Clay_SetBlendMode(rendererData, SDL_BLENDMODE_NONE);
+            SDL_Clay_SetDrawColor(rendererData, clearColor);
+            SDL_RenderFillRect(renderer, &clearRect);
+            SDL_Clay_RenderClayCommandsClipped(rendererData, &layoutDiff->renderCommands, &damageRect);
+        }
+        SDL_Clay_ApplyClipRect(rendererData, NULL);
+    }
+    SDL_Clay_SetTarget(rendererData, previousTarget);
+    rendererData->retainedTargetValid = true;
+
+    SDL_RenderTexture(renderer, rendererData->retainedTarget, NULL, NULL);
 }
@@ -4,10 +4,145 @@
 #include <SDL3_ttf/SDL_ttf.h>
 #include "clay.h"
 
+typedef struct SDL_Clay_CachedText SDL_Clay_CachedText;
+
+// Text objects drawn in recent frames, keyed by string contents, font, size and color, so steady frames don't shape and upload text again
+typedef struct {
+	SDL_Clay_CachedText *items;
+	int32_t itemCount;
+	int32_t itemCapacity;
+	int32_t freeListHead;
+	int32_t *buckets;
+	int32_t bucketCount;
+	uint32_t generation;
+	// Totals since the cache was created
+	uint64_t textsCreated;
+	uint64_t textsDestroyed;
+	uint64_t hits;
+} SDL_Clay_TextCache;
+
+typedef struct SDL_Clay_CachedMesh SDL_Clay_CachedMesh;
+
+// Most rounded rect meshes kept at once, rects past it are tessellated every time they are drawn
+#define SDL_CLAY_MESH_CACHE_CAPACITY 512
+
+// Rounded rect meshes drawn in recent frames, built at the origin and keyed by size, radius and color, so identical rects are only translated
+typedef struct {
+	SDL_Clay_CachedMesh *items;
+	int32_t itemCount;
+	int32_t freeListHead;
+	int32_t *buckets;
+	uint32_t generation;
+	// Totals since the cache was created
+	uint64_t meshesBuilt;
+	uint64_t hits;
+} SDL_Clay_MeshCache;
+
+// Upper bound of open font instances, the least recently used one is closed past it
+#define SDL_CLAY_FONT_POOL_CAPACITY 16
+
+typedef struct {
+	TTF_Font *font;
+	uint16_t fontId;
+	uint16_t fontSize;
+	uint64_t lastUsed;
+} SDL_Clay_PooledFont;
+
+// One copy of fonts[fontId] per size, opened on first use, so measuring and drawing never resize a shared font
+typedef struct {
+	SDL_Clay_PooledFont items[SDL_CLAY_FONT_POOL_CAPACITY];
+	int32_t count;
+	uint64_t useCounter;
+	// Totals since the pool was created
+	uint64_t fontsOpened;
+	uint64_t fontsClosed;
+} SDL_Clay_FontPool;
+
+// Untextured triangles of consecutive rectangles and borders, submitted with one SDL_RenderGeometry call
+typedef struct {
+	SDL_Vertex *vertices;
+	int32_t vertexCount;
+	int32_t vertexCapacity;
+	int *indices;
+	int32_t indexCount;
+	int32_t indexCapacity;
+} SDL_Clay_GeometryBatch;
+
+typedef struct SDL_Clay_ArenaBlock SDL_Clay_ArenaBlock;
+
+// Linear allocator for temporary geometry, reset at the start of every frame. A frame that doesn't fit chains another block,
+// the blocks are merged into one at the next reset, so steady frames allocate nothing.
+typedef struct {
+	SDL_Clay_ArenaBlock *blocks;
+	// Totals since the arena was created
+	uint64_t blocksAllocated;
+	// Most bytes in use at once
+	size_t peakBytes;
+} SDL_Clay_FrameArena;
+
+// Draw calls submitted to SDL by the last frame, see SDL_Clay_GetDrawStats
+typedef struct {
+	// SDL_RenderGeometry calls of the geometry batch
+	int32_t geometryDraws;
+	int32_t textDraws;
+	int32_t imageDraws;
+	int32_t clipChanges;
+	// Rectangles and borders appended to the batch, each of them used to be its own draw call
+	int32_t batchedShapes;
+	// Blend mode, draw color, clip rect and render target changes sent to SDL, and the ones skipped because the state was already set
+	int32_t stateChangesIssued;
+	int32_t stateChangesSkipped;
+} SDL_Clay_DrawStats;
+
+// The renderer state last set by this renderer. Forgotten at the start of every frame, the application may change it in between.
+typedef struct {
+	bool blendModeKnown;
+	SDL_BlendMode blendMode;
+	bool drawColorKnown;
+	SDL_Color drawColor;
+	bool clipRectKnown;
+	bool clipEnabled;
+	SDL_Rect clipRect;
+	bool targetKnown;
+	SDL_Texture *target;
+} SDL_Clay_RenderState;
+
 typedef struct {
 	SDL_Renderer *renderer;
 	TTF_TextEngine *textEngine;
+	// Fonts as loaded, indexed by fontId, the pool copies them and never changes their size
 	TTF_Font **fonts;
+	SDL_Clay_FontPool fontPool;
+	// Owned by SDL_Clay_RenderClayCommandsDiff, keeps the previous frame so only damaged regions are redrawn
+	SDL_Texture *retainedTarget;
+	bool retainedTargetValid;
+	// Owned by SDL_Clay_RenderClayCommands and SDL_Clay_RenderClayCommandsDiff, see SDL_Clay_DestroyTextCache
+	SDL_Clay_TextCache textCache;
+	// Owned by the renderer as well, see SDL_Clay_DestroyMeshCache
+	SDL_Clay_MeshCache meshCache;
+	// Flushed at scissor changes, text and image draws and at the end of the frame, see SDL_Clay_DestroyGeometryBatch
+	SDL_Clay_GeometryBatch geometryBatch;
+	SDL_Clay_DrawStats drawStats;
+	SDL_Clay_RenderState renderState;
+	// Backs the vertices and indices built while drawing, see SDL_Clay_DestroyFrameArena
+	SDL_Clay_FrameArena frameArena;
 } Clay_SDL3RendererData;
 
 void SDL_Clay_RenderClayCommands(Clay_SDL3RendererData *rendererData, Clay_RenderCommandArray *renderCommands);
+// Renders into rendererData->retainedTarget, redrawing only the damage rects of the diff, then copies it to the current target.
+// Replaces SDL_RenderClear + SDL_Clay_RenderClayCommands.
+void SDL_Clay_RenderClayCommandsDiff(Clay_SDL3RendererData *rendererData, Clay_LayoutDiff *layoutDiff, SDL_Color clearColor);
+// Destroys the cached text objects, call it before destroying the text engine or closing the fonts.
+void SDL_Clay_DestroyTextCache(Clay_SDL3RendererData *rendererData);
+// Frees the cached rounded rect meshes.
+void SDL_Clay_DestroyMeshCache(Clay_SDL3RendererData *rendererData);
+// Frees the vertex and index buffers of the geometry batch.
+void SDL_Clay_DestroyGeometryBatch(Clay_SDL3RendererData *rendererData);
+// Frees the blocks of the frame arena.
+void SDL_Clay_DestroyFrameArena(Clay_SDL3RendererData *rendererData);
+// Returns the draw calls submitted by the last SDL_Clay_RenderClayCommands or SDL_Clay_RenderClayCommandsDiff.
+SDL_Clay_DrawStats SDL_Clay_GetDrawStats(const Clay_SDL3RendererData *rendererData);
+// Returns fonts[fontId] at fontSize, opening it on first use. Valid until SDL_CLAY_FONT_POOL_CAPACITY other sizes were requested after it.
+TTF_Font *SDL_Clay_GetFont(Clay_SDL3RendererData *rendererData, uint16_t fontId, uint16_t fontSize);
+// Closes the pooled fonts, call it after SDL_Clay_DestroyTextCache and before closing rendererData->fonts.
+void SDL_Clay_DestroyFontPool(Clay_SDL3RendererData *rendererData);
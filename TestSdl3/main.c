@@ -278,22 +278,56 @@ Clay_RenderCommandArray ClayVideoDemo_CreateLayout(ClayVideoDemo_Data *data) {
     return renderCommands;
 }
 
+// Left button transitions kept between two frames, more than this in one frame are applied early
+#define POINTER_MAX_TRANSITIONS 16
+
+typedef struct {
+    Clay_Vector2 position;
+    bool down;
+} PointerTransition;
+
+// Mouse events since the last frame. Every Clay_SetPointerState hit-tests the whole tree, so motion only keeps the
+// latest position and the state is applied once per frame, plus once per press or release so none of them is lost.
+typedef struct {
+    Clay_Vector2 position;
+    bool down;
+    PointerTransition transitions[POINTER_MAX_TRANSITIONS];
+    int transitionCount;
+    // Wheel movement since the last frame, scroll containers are updated once per frame with it
+    Clay_Vector2 scrollDelta;
+} PointerInput;
+
 typedef struct app_state {
     SDL_Window *window;
     Clay_SDL3RendererData rendererData;
     ClayVideoDemo_Data demoData;
+    PointerInput pointer;
+    Uint64 lastFrameNs;
+    // Set by events Clay_NeedsLayout can't see, the next iteration lays out and draws a frame
+    bool redrawRequested;
+    // SDL_HINT_MAIN_CALLBACK_RATE is "waitevent" while nothing changes, SDL_AppIterate then only runs after an event
+    bool waitingForEvents;
 } AppState;
 
 SDL_Texture *sample_image;
 bool show_demo = true;
 
+// --bench N renders N frames on an offscreen window after a short warmup, then reports the text cache counters
+#define BENCH_WARMUP_FRAMES 3
+static int bench_frames = 0;
+static int bench_frame = 0;
+static Uint64 bench_start_ns = 0;
+static SDL_Clay_TextCache bench_warm_cache;
+static Uint64 bench_warm_meshes_built = 0;
+static Uint64 bench_warm_mesh_hits = 0;
+static Uint64 bench_warm_arena_blocks = 0;
+
 static inline Clay_Dimensions SDL_MeasureText(Clay_StringSlice text, Clay_TextElementConfig *config, void *userData)
 {
-    TTF_Font **fonts = userData;
-    TTF_Font *font = fonts[config->fontId];
+    Clay_SDL3RendererData *rendererData = userData;
+    TTF_Font *font = SDL_Clay_GetFont(rendererData, config->fontId, config->fontSize);
     int width, height;
 
-    TTF_SetFontSize(font, config->fontSize);
     if (!TTF_GetStringSize(font, text.chars, text.length, &width, &height)) {
         SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Failed to measure text: %s", SDL_GetError());
     }
@@ -301,6 +335,51 @@ static inline Clay_Dimensions SDL_MeasureText(Clay_StringSlice text, Clay_TextEl
     return (Clay_Dimensions) { (float) width, (float) height };
 }
 
+static void ApplyPointerTransitions(PointerInput *pointer)
+{
+    for (int i = 0; i < pointer->transitionCount; i++) {
+        Clay_SetPointerState(pointer->transitions[i].position, pointer->transitions[i].down);
+    }
+    pointer->transitionCount = 0;
+}
+
+static void RecordPointerButton(PointerInput *pointer, Clay_Vector2 position, bool down)
+{
+    pointer->position = position;
+    if (down == pointer->down) {
+        return;
+    }
+    if (pointer->transitionCount == POINTER_MAX_TRANSITIONS) {
+        ApplyPointerTransitions(pointer);
+    }
+    pointer->transitions[pointer->transitionCount++] = (PointerTransition) { position, down };
+    pointer->down = down;
+}
+
+// Called once per frame before the layout, Clay needs a pointer update every frame to advance PRESSED_THIS_FRAME and RELEASED_THIS_FRAME,
+// and a scroll container update every frame to progress momentum
+static void ApplyPointerInput(PointerInput *pointer, float deltaTime)
+{
+    const bool moved_after_last_transition = pointer->transitionCount == 0 ||
+        pointer->transitions[pointer->transitionCount - 1].position.x != pointer->position.x ||
+        pointer->transitions[pointer->transitionCount - 1].position.y != pointer->position.y;
+    ApplyPointerTransitions(pointer);
+    if (moved_after_last_transition) {
+        Clay_SetPointerState(pointer->position, pointer->down);
+    }
+    Clay_UpdateScrollContainers(true, pointer->scrollDelta, deltaTime);
+    pointer->scrollDelta = (Clay_Vector2) { 0, 0 };
+}
+
+// Switches SDL between calling SDL_AppIterate every frame and only after events
+static void SetWaitForEvents(AppState *state, bool wait)
+{
+    if (state->waitingForEvents != wait) {
+        SDL_SetHint(SDL_HINT_MAIN_CALLBACK_RATE, wait ? "waitevent" : "0");
+        state->waitingForEvents = wait;
+    }
+}
+
 void HandleClayErrors(Clay_ErrorData errorData) {
     printf("%s", errorData.errorText.chars);
 }
@@ -337,10 +416,60 @@ Clay_RenderCommandArray ClayImageSample_CreateLayout() {
 }
 
 
+// Steady frames are expected to draw every text from the cache, any text object created after the warmup fails the run
+static SDL_AppResult BenchFrameDone(AppState *state)
+{
+    const SDL_Clay_TextCache *cache = &state->rendererData.textCache;
+    bench_frame++;
+    if (bench_frame == BENCH_WARMUP_FRAMES) {
+        bench_warm_cache = *cache;
+        bench_warm_meshes_built = state->rendererData.meshCache.meshesBuilt;
+        bench_warm_mesh_hits = state->rendererData.meshCache.hits;
+        bench_warm_arena_blocks = state->rendererData.frameArena.blocksAllocated;
+        bench_start_ns = SDL_GetTicksNS();
+    }
+    if (bench_frame < BENCH_WARMUP_FRAMES + bench_frames) {
+        return SDL_APP_CONTINUE;
+    }
+
+    const Uint64 elapsed_ns = SDL_GetTicksNS() - bench_start_ns;
+    const Uint64 created = cache->textsCreated - bench_warm_cache.textsCreated;
+    SDL_Log("bench: %d frames, %.1f us/frame", bench_frames, (double) elapsed_ns / 1000.0 / bench_frames);
+    SDL_Log("bench: warmup created %llu text objects", (unsigned long long) bench_warm_cache.textsCreated);
+    SDL_Log("bench: steady state created %llu, destroyed %llu, drew %.1f cached texts/frame",
+            (unsigned long long) created,
+            (unsigned long long) (cache->textsDestroyed - bench_warm_cache.textsDestroyed),
+            (double) (cache->hits - bench_warm_cache.hits) / bench_frames);
+    SDL_Log("bench: %.1f rounded rect meshes built/frame, %.1f reused/frame",
+            (double) (state->rendererData.meshCache.meshesBuilt - bench_warm_meshes_built) / bench_frames,
+            (double) (state->rendererData.meshCache.hits - bench_warm_mesh_hits) / bench_frames);
+    const SDL_Clay_DrawStats draws = SDL_Clay_GetDrawStats(&state->rendererData);
+    SDL_Log("bench: last frame submitted %d geometry, %d text, %d image draws for %d batched shapes, %d clip changes",
+            draws.geometryDraws, draws.textDraws, draws.imageDraws, draws.batchedShapes, draws.clipChanges);
+    SDL_Log("bench: last frame issued %d state changes, skipped %d redundant ones",
+            draws.stateChangesIssued, draws.stateChangesSkipped);
+    SDL_Log("bench: frame arena peaked at %zu bytes, steady state allocated %llu blocks",
+            state->rendererData.frameArena.peakBytes,
+            (unsigned long long) (state->rendererData.frameArena.blocksAllocated - bench_warm_arena_blocks));
+    SDL_Log("bench: %d font instances open, %llu opened, %llu closed",
+            state->rendererData.fontPool.count,
+            (unsigned long long) state->rendererData.fontPool.fontsOpened,
+            (unsigned long long) state->rendererData.fontPool.fontsClosed);
+    return created == 0 ? SDL_APP_SUCCESS : SDL_APP_FAILURE;
+}
+
 SDL_AppResult SDL_AppInit(void **appstate, int argc, char *argv[])
 {
-    (void) argc;
-    (void) argv;
+    for (int i = 1; i < argc; i++) {
+        if (SDL_strcmp(argv[i], "--bench") == 0 && i + 1 < argc) {
+            bench_frames = SDL_atoi(argv[++i]);
+        }
+    }
+    if (bench_frames > 0) {
+        // No display needed, the software renderer draws into an offscreen or dummy window
+        SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen,dummy");
+        SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+    }
 
     if (!TTF_Init()) {
         return SDL_APP_FAILURE;
@@ -395,7 +524,11 @@ SDL_AppResult SDL_AppInit(void **appstate, int argc, char *argv[])
     int width, height;
     SDL_GetWindowSize(state->window, &width, &height);
     Clay_Initialize(clayMemory, (Clay_Dimensions) { (float) width, (float) height }, (Clay_ErrorHandler) { HandleClayErrors });
-    Clay_SetMeasureTextFunction(SDL_MeasureText, state->rendererData.fonts);
+    Clay_SetMeasureTextFunction(SDL_MeasureText, &state->rendererData);
+    // Documents are string literals, keep their measurements so switching back to one doesn't measure it again
+    Clay_SetMeasureTextCachePolicy((Clay_MeasureTextCachePolicy) { .maxUnusedFrames = 0, .pinStaticStrings = true });
+    // Scrolling a document only moves it, so incremental layout skips sizing and wrapping it again
+    Clay_SetIncrementalLayoutEnabled(true);
 	Clay_SetDebugModeEnabled(true);
     state->demoData = ClayVideoDemo_Initialize();
 
@@ -405,8 +538,21 @@ SDL_AppResult SDL_AppInit(void **appstate, int argc, char *argv[])
 
 SDL_AppResult SDL_AppEvent(void *appstate, SDL_Event *event)
 {
+    AppState *state = appstate;
     SDL_AppResult ret_val = SDL_APP_CONTINUE;
 
+    switch (event->type) {
+        case SDL_EVENT_MOUSE_MOTION:
+        case SDL_EVENT_MOUSE_BUTTON_DOWN:
+        case SDL_EVENT_MOUSE_BUTTON_UP:
+        case SDL_EVENT_MOUSE_WHEEL:
+            // Clay_NeedsLayout tells whether these changed anything
+            break;
+        default:
+            state->redrawRequested = true;
+            break;
+    }
+
     switch (event->type) {
         case SDL_EVENT_QUIT:
             ret_val = SDL_APP_SUCCESS;
@@ -420,15 +566,19 @@ SDL_AppResult SDL_AppEvent(void *appstate, SDL_Event *event)
             Clay_SetLayoutDimensions((Clay_Dimensions) { (float) event->window.data1, (float) event->window.data2 });
             break;
         case SDL_EVENT_MOUSE_MOTION:
-            Clay_SetPointerState((Clay_Vector2) { event->motion.x, event->motion.y },
-                                 event->motion.state & SDL_BUTTON_LMASK);
+            state->pointer.position = (Clay_Vector2) { event->motion.x, event->motion.y };
             break;
         case SDL_EVENT_MOUSE_BUTTON_DOWN:
-            Clay_SetPointerState((Clay_Vector2) { event->button.x, event->button.y },
-                                 event->button.button == SDL_BUTTON_LEFT);
+        case SDL_EVENT_MOUSE_BUTTON_UP:
+            if (event->button.button == SDL_BUTTON_LEFT) {
+                RecordPointerButton(&state->pointer, (Clay_Vector2) { event->button.x, event->button.y }, event->button.down);
+            } else {
+                state->pointer.position = (Clay_Vector2) { event->button.x, event->button.y };
+            }
             break;
         case SDL_EVENT_MOUSE_WHEEL:
-            Clay_UpdateScrollContainers(true, (Clay_Vector2) { event->wheel.x, event->wheel.y }, 0.01f);
+            state->pointer.scrollDelta.x += event->wheel.x;
+            state->pointer.scrollDelta.y += event->wheel.y;
             break;
         default:
             break;
@@ -441,6 +591,19 @@ SDL_AppResult SDL_AppIterate(void *appstate)
 {
     AppState *state = appstate;
 
+    const Uint64 now_ns = SDL_GetTicksNS();
+    const float delta_time = state->lastFrameNs ? (float) (now_ns - state->lastFrameNs) / 1e9f : 0.0f;
+    state->lastFrameNs = now_ns;
+    ApplyPointerInput(&state->pointer, delta_time);
+
+    // The last frame is still presented, skip the layout and wait for the next event. The benchmark draws every frame.
+    if (bench_frames == 0 && !state->redrawRequested && !Clay_NeedsLayout()) {
+        SetWaitForEvents(state, true);
+        return SDL_APP_CONTINUE;
+    }
+    SetWaitForEvents(state, false);
+    state->redrawRequested = false;
+
     Clay_RenderCommandArray render_commands = (show_demo
         ? ClayVideoDemo_CreateLayout(&state->demoData)
         : ClayImageSample_CreateLayout()
@@ -453,6 +616,9 @@ SDL_AppResult SDL_AppIterate(void *appstate)
 
     SDL_RenderPresent(state->rendererData.renderer);
 
+    if (bench_frames > 0) {
+        return BenchFrameDone(state);
+    }
     return SDL_APP_CONTINUE;
 }
 
@@ -471,6 +637,12 @@ void SDL_AppQuit(void *appstate, SDL_AppResult result)
     }
 
     if (state) {
+        SDL_Clay_DestroyTextCache(&state->rendererData);
+        SDL_Clay_DestroyFontPool(&state->rendererData);
+        SDL_Clay_DestroyMeshCache(&state->rendererData);
+        SDL_Clay_DestroyGeometryBatch(&state->rendererData);
+        SDL_Clay_DestroyFrameArena(&state->rendererData);
+
         if (state->rendererData.renderer)
             SDL_DestroyRenderer(state->rendererData.renderer);
 